@@ -0,0 +1,136 @@
+/**
+ * @file AudioBufferBenchmark.cpp
+ * @brief Throughput comparison of the SPSC AudioBuffer against the previous mutex ring
+ *
+ * Usage:
+ *   ./bench-audio-buffer [block_frames] [seconds_of_audio]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "AudioBuffer.h"
+
+namespace
+{
+    /**
+     * @brief The original mutex-guarded, sample-at-a-time ring buffer, kept as a baseline
+     */
+    class MutexAudioBuffer
+    {
+    public:
+        explicit MutexAudioBuffer(size_t size) : buffer_(size), size_(size) {}
+
+        size_t write(const float *data, size_t numSamples)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t toWrite = std::min(numSamples, size_ - available_);
+            for (size_t i = 0; i < toWrite; i++)
+            {
+                buffer_[writeIndex_] = data[i];
+                writeIndex_ = (writeIndex_ + 1) % size_;
+            }
+            available_ += toWrite;
+            return toWrite;
+        }
+
+        size_t read(float *data, size_t numSamples)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t toRead = std::min(numSamples, available_);
+            for (size_t i = 0; i < toRead; i++)
+            {
+                data[i] = buffer_[readIndex_];
+                readIndex_ = (readIndex_ + 1) % size_;
+            }
+            available_ -= toRead;
+            return toRead;
+        }
+
+    private:
+        std::vector<float> buffer_;
+        size_t size_;
+        std::mutex mutex_;
+        size_t writeIndex_ = 0;
+        size_t readIndex_ = 0;
+        size_t available_ = 0;
+    };
+
+    /**
+     * @brief Stream totalSamples through the buffer with one producer and one consumer thread
+     * @return Samples per second
+     */
+    template <typename Buffer>
+    double runProducerConsumer(Buffer &buffer, size_t blockFrames, size_t totalSamples)
+    {
+        std::vector<float> input(blockFrames, 0.25f);
+        std::vector<float> output(blockFrames);
+        std::atomic<bool> done{false};
+
+        auto start = std::chrono::steady_clock::now();
+
+        std::thread producer([&]()
+                             {
+            size_t written = 0;
+            while (written < totalSamples)
+            {
+                size_t n = buffer.write(input.data(), std::min(blockFrames, totalSamples - written));
+                if (n == 0)
+                {
+                    std::this_thread::yield();
+                }
+                written += n;
+            }
+            done.store(true); });
+
+        size_t consumed = 0;
+        while (consumed < totalSamples)
+        {
+            size_t n = buffer.read(output.data(), blockFrames);
+            if (n == 0)
+            {
+                std::this_thread::yield();
+            }
+            consumed += n;
+        }
+
+        producer.join();
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        return static_cast<double>(totalSamples) / seconds;
+    }
+
+    void report(const char *name, double samplesPerSecond)
+    {
+        std::cout << "  " << std::left << std::setw(20) << name
+                  << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+                  << samplesPerSecond / 1e6 << " Msamples/s  ("
+                  << std::setprecision(0) << samplesPerSecond / 16000.0 << "x realtime @16kHz)" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t blockFrames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 128;
+    const size_t seconds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 3600;
+    const size_t totalSamples = seconds * 16000;
+    const size_t ringSize = 32768; // ~2 s at 16 kHz, same order as AudioCapture
+
+    std::cout << "AudioBuffer benchmark: " << blockFrames << "-sample blocks, "
+              << seconds << " s of 16 kHz audio" << std::endl;
+
+    MutexAudioBuffer mutexBuffer(ringSize);
+    report("mutex (legacy)", runProducerConsumer(mutexBuffer, blockFrames, totalSamples));
+
+    AudioBuffer spscBuffer(ringSize);
+    report("spsc (AudioBuffer)", runProducerConsumer(spscBuffer, blockFrames, totalSamples));
+
+    return 0;
+}
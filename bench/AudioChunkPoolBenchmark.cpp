@@ -0,0 +1,187 @@
+/**
+ * @file AudioChunkPoolBenchmark.cpp
+ * @brief Heap allocations and copy cost per capture callback: vector hand-off vs. pooled chunks
+ *
+ * Replays the capture -> transcriber path on one thread: a 20 ms frame is
+ * delivered, queued, dequeued into the 10 s transcription buffer, and the
+ * buffer is handed to a stand-in for whisper when full. Global operator new
+ * is counted, so the report shows allocations per callback after warm-up.
+ *
+ * Usage:
+ *   ./bench-audio-chunk-pool [seconds_of_audio] [backlog_frames]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <queue>
+#include <vector>
+
+#include "AudioChunkPool.h"
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations{0};
+}
+
+void *operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    constexpr size_t kFrameSamples = 320;          // 20 ms at 16 kHz
+    constexpr size_t kBufferSamples = 10 * 16000;  // WhisperTranscriber's buffer
+    volatile float g_sink = 0.0f;
+
+    /**
+     * @brief Stand-in for whisper_full: touch the audio so the copy is not optimized out
+     */
+    void consume(const float *samples, size_t count)
+    {
+        g_sink = g_sink + samples[0] + samples[count - 1];
+    }
+
+    struct Run
+    {
+        double nsPerCallback = 0.0;
+        double allocationsPerCallback = 0.0;
+    };
+
+    /**
+     * @brief The previous path: frame vector -> queue copy -> front() copy -> buffer -> full buffer copy
+     */
+    Run runVectorPath(size_t frames, size_t backlog)
+    {
+        std::vector<float> frame(kFrameSamples, 0.25f);
+        std::queue<std::pair<std::vector<float>, double>> queue;
+        std::vector<float> buffer;
+        buffer.reserve(kBufferSamples);
+
+        uint64_t allocationsAtWarm = 0;
+        auto start = std::chrono::steady_clock::now();
+        const size_t warmup = frames / 10;
+
+        for (size_t i = 0; i < frames; i++)
+        {
+            if (i == warmup)
+            {
+                allocationsAtWarm = g_allocations.load();
+                start = std::chrono::steady_clock::now();
+            }
+
+            queue.push(std::make_pair(frame, i * 0.02));
+
+            // The consumer runs behind by `backlog` frames, as it does while whisper is busy
+            while (queue.size() > backlog)
+            {
+                auto item = queue.front();
+                queue.pop();
+                buffer.insert(buffer.end(), item.first.begin(), item.first.end());
+                if (buffer.size() >= kBufferSamples)
+                {
+                    std::vector<float> toProcess = buffer;
+                    buffer.clear();
+                    consume(toProcess.data(), toProcess.size());
+                }
+            }
+        }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const size_t measured = frames - warmup;
+        return {seconds * 1e9 / measured, static_cast<double>(g_allocations.load() - allocationsAtWarm) / measured};
+    }
+
+    /**
+     * @brief The pooled path: chunk from the pool -> handle queue -> buffer -> whisper reads the buffer in place
+     */
+    Run runChunkPath(size_t frames, size_t backlog, AudioChunkPool::Stats &stats)
+    {
+        AudioChunkPool pool(kFrameSamples, 64);
+        AudioChunkQueue queue;
+        std::vector<float> buffer;
+        buffer.reserve(kBufferSamples + kFrameSamples);
+
+        uint64_t allocationsAtWarm = 0;
+        auto start = std::chrono::steady_clock::now();
+        const size_t warmup = frames / 10;
+
+        for (size_t i = 0; i < frames; i++)
+        {
+            if (i == warmup)
+            {
+                allocationsAtWarm = g_allocations.load();
+                start = std::chrono::steady_clock::now();
+            }
+
+            AudioChunkHandle chunk = pool.acquire(kFrameSamples);
+            std::fill(chunk->data(), chunk->data() + kFrameSamples, 0.25f);
+            chunk->setTimestamp(i * 0.02);
+            queue.push(std::move(chunk));
+
+            AudioChunkHandle item;
+            while (queue.size() > backlog && queue.pop(item))
+            {
+                buffer.insert(buffer.end(), item->data(), item->data() + item->size());
+                item.reset();
+                if (buffer.size() >= kBufferSamples)
+                {
+                    consume(buffer.data(), buffer.size());
+                    buffer.clear();
+                }
+            }
+        }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const size_t measured = frames - warmup;
+        stats = pool.getStats();
+        return {seconds * 1e9 / measured, static_cast<double>(g_allocations.load() - allocationsAtWarm) / measured};
+    }
+
+    void report(const char *name, const Run &run)
+    {
+        std::cout << "  " << std::left << std::setw(22) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(1)
+                  << run.nsPerCallback << " ns/callback  "
+                  << std::setw(8) << std::setprecision(3) << run.allocationsPerCallback << " allocs/callback" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t seconds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 3600;
+    const size_t backlog = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 250;
+    const size_t frames = seconds * 50;
+
+    std::cout << "Audio hand-off benchmark: " << frames << " callbacks of 20 ms, consumer "
+              << backlog << " frames behind (steady state after 10% warm-up)" << std::endl;
+
+    report("vector (legacy)", runVectorPath(frames, backlog));
+
+    AudioChunkPool::Stats stats;
+    report("pooled chunks", runChunkPath(frames, backlog, stats));
+    std::cout << "  pool: " << stats.chunksAllocated << " chunks allocated for " << stats.acquired
+              << " acquires" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file LlamaPrefillBenchmark.cpp
+ * @brief Prompt prefill throughput of the llama bridge against the batch size
+ *
+ * For every batch size the model is loaded with n_batch = n_ubatch = size and
+ * a transcript-like prompt of the requested length is prefilled into an empty
+ * session (reset between runs, so nothing comes from the KV cache). Prefill
+ * time is the bridge's time to first token. The fastest size is the one to put
+ * in LLMClient::Config::ubatchSize on this host.
+ *
+ * Usage:
+ *   ./bench-llama-prefill <model_path> [prompt_tokens] [repeats] [threads]
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "LlamaBridge.h"
+
+namespace
+{
+    const char *const kLectureText = "Today we continue with the second law of thermodynamics. The entropy of an isolated "
+                                     "system never decreases, and for a reversible process the change in entropy equals the "
+                                     "heat transferred divided by the absolute temperature. As an example, consider an ideal "
+                                     "gas expanding into a vacuum: no work is done and no heat flows, yet the entropy rises. ";
+
+    /**
+     * @brief Repeat the lecture text until it tokenizes to at least tokens tokens
+     */
+    std::string makePrompt(llama_bridge_context *ctx, int tokens)
+    {
+        std::string prompt;
+        int count = 0;
+        while (count < tokens)
+        {
+            prompt += kLectureText;
+            llama_bridge_tokens tokenized = llama_bridge_tokenize(ctx, prompt.c_str());
+            count = tokenized.count;
+            llama_bridge_free_tokens(&tokenized);
+            if (count == 0)
+            {
+                break;
+            }
+        }
+        return prompt;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <model_path> [prompt_tokens] [repeats] [threads]" << std::endl;
+        return 1;
+    }
+
+    const int promptTokens = argc > 2 ? std::max(64, std::atoi(argv[2])) : 4096;
+    const int repeats = argc > 3 ? std::max(1, std::atoi(argv[3])) : 3;
+    const int threads = argc > 4 ? std::max(1, std::atoi(argv[4])) : 4;
+    const int batchSizes[] = {32, 64, 128, 256, 512, 1024, 2048};
+
+    std::cout << "Llama prefill benchmark: ~" << promptTokens << " prompt tokens, " << threads << " threads, "
+              << repeats << " runs per point" << std::endl;
+    std::cout << "  batch    prefill ms    tok/s" << std::endl;
+
+    int bestBatch = 0;
+    double bestRate = 0.0;
+
+    for (int batch : batchSizes)
+    {
+        llama_bridge_params params = {};
+        params.model_path = argv[1];
+        params.threads = threads;
+        params.context_size = promptTokens + promptTokens / 8 + 64;
+        params.max_tokens = 1;
+        params.temperature = 0.0f;
+        params.max_sessions = 1;
+        params.batch_size = batch;
+        params.ubatch_size = batch;
+
+        llama_bridge_context *ctx = llama_bridge_init(params);
+        if (!ctx)
+        {
+            std::cerr << "Failed to load model: " << argv[1] << std::endl;
+            return 1;
+        }
+        llama_bridge_warmup(ctx);
+
+        const std::string prompt = makePrompt(ctx, promptTokens);
+        const llama_bridge_session session = llama_bridge_session_create(ctx);
+
+        double totalMs = 0.0;
+        int tokens = 0;
+        bool ok = session >= 0;
+        for (int r = 0; ok && r < repeats; r++)
+        {
+            llama_bridge_session_reset(ctx, session);
+            llama_bridge_result result = llama_bridge_session_generate(ctx, session, prompt.c_str(), 1, nullptr, nullptr);
+            ok = result.success;
+            totalMs += result.time_to_first_token_ms;
+            tokens = result.prompt_tokens;
+            llama_bridge_free_result(&result);
+        }
+        llama_bridge_free(ctx);
+
+        if (!ok)
+        {
+            std::cout << "  " << std::setw(5) << batch << "    failed" << std::endl;
+            continue;
+        }
+
+        const double ms = totalMs / repeats;
+        const double rate = ms > 0.0 ? tokens * 1000.0 / ms : 0.0;
+        if (rate > bestRate)
+        {
+            bestRate = rate;
+            bestBatch = batch;
+        }
+        std::cout << "  " << std::setw(5) << batch << std::fixed << std::setprecision(1)
+                  << std::setw(14) << ms << std::setw(9) << std::setprecision(0) << rate << std::endl;
+    }
+
+    if (bestBatch > 0)
+    {
+        std::cout << "Fastest: batch " << bestBatch << " (" << std::fixed << std::setprecision(0) << bestRate << " tok/s)"
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file ResamplerBenchmark.cpp
+ * @brief Quality and throughput of the polyphase Resampler for each supported device rate
+ *
+ * Quality: SNR of a resampled 1 kHz tone, and attenuation of a tone above the
+ * 8 kHz output Nyquist. Throughput: cost of one live stream, in CPU per second of audio.
+ *
+ * Usage:
+ *   ./bench-resampler [seconds_of_audio] [chunk_ms]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "Resampler.h"
+
+namespace
+{
+    constexpr double PI = 3.14159265358979323846;
+    constexpr unsigned int OUTPUT_RATE = 16000;
+
+    std::vector<float> tone(unsigned int rate, double frequency, double seconds)
+    {
+        std::vector<float> samples(static_cast<size_t>(rate * seconds));
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            samples[i] = static_cast<float>(0.5 * std::sin(2.0 * PI * frequency * i / rate));
+        }
+        return samples;
+    }
+
+    std::vector<float> resampleAll(Resampler &resampler, const std::vector<float> &input, size_t chunk)
+    {
+        std::vector<float> output;
+        std::vector<float> block(resampler.maxOutputFor(chunk));
+        for (size_t offset = 0; offset < input.size(); offset += chunk)
+        {
+            size_t n = std::min(chunk, input.size() - offset);
+            size_t produced = resampler.process(input.data() + offset, n, block.data(), block.size());
+            output.insert(output.end(), block.begin(), block.begin() + produced);
+        }
+        return output;
+    }
+
+    /**
+     * @brief Least-squares fit of a sinusoid at a known frequency; returns signal and residual power
+     */
+    void fitTone(const std::vector<float> &samples, size_t skip, double frequency, double &signalPower, double &noisePower)
+    {
+        double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+        for (size_t i = skip; i + skip < samples.size(); i++)
+        {
+            double s = std::sin(2.0 * PI * frequency * i / OUTPUT_RATE);
+            double c = std::cos(2.0 * PI * frequency * i / OUTPUT_RATE);
+            ss += s * s;
+            sc += s * c;
+            cc += c * c;
+            ys += samples[i] * s;
+            yc += samples[i] * c;
+        }
+        double det = ss * cc - sc * sc;
+        double a = (ys * cc - yc * sc) / det;
+        double b = (yc * ss - ys * sc) / det;
+
+        signalPower = 0.0;
+        noisePower = 0.0;
+        size_t count = 0;
+        for (size_t i = skip; i + skip < samples.size(); i++)
+        {
+            double fit = a * std::sin(2.0 * PI * frequency * i / OUTPUT_RATE) + b * std::cos(2.0 * PI * frequency * i / OUTPUT_RATE);
+            signalPower += fit * fit;
+            noisePower += (samples[i] - fit) * (samples[i] - fit);
+            count++;
+        }
+        signalPower /= count;
+        noisePower /= count;
+    }
+
+    double rms(const std::vector<float> &samples, size_t skip)
+    {
+        double sum = 0.0;
+        size_t count = 0;
+        for (size_t i = skip; i + skip < samples.size(); i++)
+        {
+            sum += samples[i] * samples[i];
+            count++;
+        }
+        return std::sqrt(sum / std::max<size_t>(count, 1));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 600.0;
+    const unsigned int chunkMs = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::cout << "Resampler benchmark: " << seconds << " s per stream, " << chunkMs << " ms chunks" << std::endl;
+    std::cout << "  input Hz  taps  1kHz SNR dB  alias rej dB   ns/out sample   CPU %/stream   streams/core" << std::endl;
+
+    for (unsigned int inputRate : {8000u, 22050u, 24000u, 32000u, 44100u, 48000u, 96000u})
+    {
+        const size_t chunk = inputRate * chunkMs / 1000;
+
+        // Quality: in-band tone and a tone that would alias (skipped for upsampling)
+        Resampler qualityResampler(inputRate, OUTPUT_RATE, chunk);
+        auto passband = resampleAll(qualityResampler, tone(inputRate, 1000.0, 2.0), chunk);
+        const size_t skip = qualityResampler.getTapsPerPhase() * 2;
+        double signalPower = 0.0, noisePower = 0.0;
+        fitTone(passband, skip, 1000.0, signalPower, noisePower);
+        double snrDb = 10.0 * std::log10(signalPower / noisePower);
+
+        double rejectionDb = 0.0;
+        if (inputRate > OUTPUT_RATE)
+        {
+            const double aliasFrequency = std::min(0.45 * inputRate, 9000.0);
+            Resampler aliasResampler(inputRate, OUTPUT_RATE, chunk);
+            auto aliased = resampleAll(aliasResampler, tone(inputRate, aliasFrequency, 2.0), chunk);
+            rejectionDb = 20.0 * std::log10(0.5 / std::sqrt(2.0) / std::max(rms(aliased, skip), 1e-12));
+        }
+
+        // Throughput: stream `seconds` of audio through one instance in chunkMs pieces
+        auto input = tone(inputRate, 440.0, std::min(seconds, 10.0));
+        Resampler resampler(inputRate, OUTPUT_RATE, chunk);
+        std::vector<float> block(resampler.maxOutputFor(chunk));
+        size_t produced = 0;
+        const size_t totalInput = static_cast<size_t>(inputRate * seconds);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t done = 0; done < totalInput; done += chunk)
+        {
+            size_t offset = done % (input.size() - chunk);
+            produced += resampler.process(input.data() + offset, chunk, block.data(), block.size());
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double cpuShare = elapsed / seconds;
+
+        std::cout << std::fixed << "  " << std::setw(8) << inputRate
+                  << std::setw(6) << resampler.getTapsPerPhase()
+                  << std::setprecision(1) << std::setw(13) << snrDb
+                  << std::setw(14);
+        if (inputRate > OUTPUT_RATE)
+        {
+            std::cout << rejectionDb;
+        }
+        else
+        {
+            std::cout << "-";
+        }
+        std::cout << std::setprecision(2) << std::setw(16) << elapsed * 1e9 / produced
+                  << std::setprecision(4) << std::setw(15) << cpuShare * 100.0
+                  << std::setprecision(0) << std::setw(15) << 1.0 / cpuShare << std::endl;
+    }
+
+    return 0;
+}
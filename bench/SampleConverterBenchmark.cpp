@@ -0,0 +1,121 @@
+/**
+ * @file SampleConverterBenchmark.cpp
+ * @brief ns per frame of the SIMD convert/downmix kernels vs. the previous two-pass conversion
+ *
+ * Usage:
+ *   ./bench-sample-converter [frames_per_callback] [iterations]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "SampleConverter.h"
+
+namespace
+{
+    /**
+     * @brief The original AudioCapture::convertToFloat: push_back conversion, then a second vector for mono
+     */
+    std::vector<float> legacyConvert(const void *input, unsigned int frames, unsigned int channels, SampleFormat format)
+    {
+        std::vector<float> output;
+        output.reserve(frames * channels);
+
+        if (format == SampleFormat::Float32)
+        {
+            const float *floatInput = static_cast<const float *>(input);
+            output.assign(floatInput, floatInput + frames * channels);
+        }
+        else if (format == SampleFormat::Int16)
+        {
+            const int16_t *shortInput = static_cast<const int16_t *>(input);
+            for (unsigned int i = 0; i < frames * channels; i++)
+            {
+                output.push_back(static_cast<float>(shortInput[i]) / 32768.0f);
+            }
+        }
+
+        if (channels > 1)
+        {
+            std::vector<float> mono;
+            mono.reserve(frames);
+            for (unsigned int i = 0; i < frames; i++)
+            {
+                float sum = 0.0f;
+                for (unsigned int ch = 0; ch < channels; ch++)
+                {
+                    sum += output[i * channels + ch];
+                }
+                mono.push_back(sum / channels);
+            }
+            return mono;
+        }
+
+        return output;
+    }
+
+    template <typename Fn>
+    double nsPerFrame(Fn &&fn, unsigned int frames, int iterations)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+        {
+            fn();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(frames) * iterations);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const unsigned int frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 128;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 200000;
+
+    std::cout << "SampleConverter benchmark (" << SampleConverter::backendName() << "), "
+              << frames << " frames/callback, " << iterations << " callbacks" << std::endl;
+    std::cout << "  format   ch   legacy ns/frame   simd ns/frame   speedup" << std::endl;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    volatile float sink = 0.0f;
+
+    for (SampleFormat format : {SampleFormat::Float32, SampleFormat::Int16})
+    {
+        for (unsigned int channels : {1u, 2u, 4u, 8u})
+        {
+            std::vector<float> f32(frames * channels);
+            std::vector<int16_t> s16(frames * channels);
+            for (size_t i = 0; i < f32.size(); i++)
+            {
+                f32[i] = dist(rng);
+                s16[i] = static_cast<int16_t>(f32[i] * 32767.0f);
+            }
+            const void *input = format == SampleFormat::Float32 ? static_cast<const void *>(f32.data())
+                                                                : static_cast<const void *>(s16.data());
+            std::vector<float> output(frames);
+
+            double legacy = nsPerFrame([&]()
+                                       { sink = sink + legacyConvert(input, frames, channels, format)[0]; },
+                                       frames, iterations);
+            double simd = nsPerFrame([&]()
+                                     {
+                SampleConverter::toMono(input, format, frames, channels, output.data());
+                sink = sink + output[0]; },
+                                     frames, iterations);
+
+            std::cout << "  " << std::left << std::setw(8) << (format == SampleFormat::Float32 ? "f32" : "s16")
+                      << std::right << std::setw(3) << channels
+                      << std::fixed << std::setprecision(3)
+                      << std::setw(18) << legacy << std::setw(16) << simd
+                      << std::setprecision(1) << std::setw(9) << legacy / simd << "x" << std::endl;
+        }
+    }
+
+    return 0;
+}
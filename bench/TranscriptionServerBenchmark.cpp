@@ -0,0 +1,184 @@
+/**
+ * @file TranscriptionServerBenchmark.cpp
+ * @brief Memory and throughput of N live sessions on one shared Whisper model
+ *
+ * Loads the model once through TranscriptionServer, opens N sessions and feeds
+ * every session the same audio in 1 s blocks, interleaved, as fast as the server
+ * takes it. Peak RSS is reported after loading the model and after opening the
+ * sessions, so the difference is what the sessions' whisper states cost.
+ * Aggregate RTF is wall time divided by the audio of all sessions together;
+ * below 1.0 the server keeps up with N live rooms. Without an input file a
+ * synthetic voiced signal is used.
+ *
+ * Usage:
+ *   ./bench-transcription-server <model_path> [input.wav|-] [sessions] [workers] [threads]
+ */
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FileAudioSource.h"
+#include "TranscriptionServer.h"
+
+namespace
+{
+    /**
+     * @brief Pulsed harmonic tone with syllable-rate amplitude modulation and a pause every 3 s
+     */
+    std::vector<float> syntheticVoice(size_t samples)
+    {
+        std::vector<float> audio(samples);
+        const double pi = 3.14159265358979323846;
+        for (size_t i = 0; i < samples; i++)
+        {
+            const double t = static_cast<double>(i) / 16000.0;
+            if (std::fmod(t, 3.0) > 2.7)
+            {
+                continue;
+            }
+            const double f0 = 140.0 + 30.0 * std::sin(2.0 * pi * 0.7 * t);
+            double v = 0.0;
+            for (int h = 1; h <= 8; h++)
+            {
+                v += std::sin(2.0 * pi * f0 * h * t) / h;
+            }
+            const double envelope = 0.5 + 0.5 * std::sin(2.0 * pi * 4.0 * t);
+            audio[i] = static_cast<float>(0.1 * envelope * v);
+        }
+        return audio;
+    }
+
+    std::vector<float> loadAudio(const std::string &path)
+    {
+        FileAudioSource::Config config;
+        config.path = path;
+        config.maxSpeed = true;
+        FileAudioSource source(config);
+        if (!source.initialize())
+        {
+            return {};
+        }
+
+        std::vector<float> audio;
+        source.start([&audio](const AudioChunkHandle &chunk)
+                     { audio.insert(audio.end(), chunk->data(), chunk->data() + chunk->size()); });
+        while (source.isCapturing())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        source.stop();
+        return audio;
+    }
+
+    /**
+     * @brief Peak resident set size of this process in MB
+     */
+    double peakRssMb()
+    {
+        struct rusage usage = {};
+        getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+        return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0); // bytes
+#else
+        return static_cast<double>(usage.ru_maxrss) / 1024.0; // KB
+#endif
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <model_path> [input.wav|-] [sessions] [workers] [threads]" << std::endl;
+        return 1;
+    }
+
+    const std::string input = argc > 2 ? argv[2] : "-";
+    const int sessions = argc > 3 ? std::max(1, std::atoi(argv[3])) : 8;
+    const int workers = argc > 4 ? std::max(1, std::atoi(argv[4])) : 4;
+    const int threads = argc > 5 ? std::max(1, std::atoi(argv[5])) : 2;
+
+    std::vector<float> audio = input == "-" ? syntheticVoice(16000 * 30) : loadAudio(input);
+    if (audio.empty())
+    {
+        std::cerr << "Failed to read audio: " << input << std::endl;
+        return 1;
+    }
+    const double audioSeconds = static_cast<double>(audio.size()) / 16000.0;
+    const double rssStart = peakRssMb();
+
+    TranscriptionServer::Config config;
+    config.modelPath = argv[1];
+    config.language = "en";
+    config.workers = workers;
+    config.threadsPerWorker = threads;
+    config.maxSessions = static_cast<size_t>(sessions);
+
+    TranscriptionServer server(config);
+    if (!server.initialize())
+    {
+        return 1;
+    }
+    const double rssModel = peakRssMb();
+
+    std::atomic<size_t> results(0);
+    std::vector<TranscriptionServer::SessionId> ids;
+    for (int i = 0; i < sessions; i++)
+    {
+        const TranscriptionServer::SessionId id = server.openSession([&results](TranscriptionServer::SessionId, const TranscriptionServer::Result &)
+                                                                     { results.fetch_add(1); });
+        if (id == 0)
+        {
+            std::cerr << "Failed to open session " << i + 1 << std::endl;
+            return 1;
+        }
+        ids.push_back(id);
+    }
+    const double rssSessions = peakRssMb();
+
+    std::cout << "Transcription server benchmark: " << sessions << " sessions x " << std::fixed << std::setprecision(1)
+              << audioSeconds << " s, " << workers << " workers x " << threads << " threads" << std::endl;
+
+    const auto started = std::chrono::steady_clock::now();
+    const size_t block = 16000;
+    for (size_t offset = 0; offset < audio.size(); offset += block)
+    {
+        const size_t end = std::min(audio.size(), offset + block);
+        const std::vector<float> samples(audio.begin() + static_cast<std::ptrdiff_t>(offset),
+                                         audio.begin() + static_cast<std::ptrdiff_t>(end));
+        for (TranscriptionServer::SessionId id : ids)
+        {
+            server.addAudio(id, samples, static_cast<double>(offset) / 16000.0);
+        }
+    }
+    for (TranscriptionServer::SessionId id : ids)
+    {
+        server.closeSession(id);
+    }
+    const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    const TranscriptionServer::Stats stats = server.getStats();
+    const double totalAudio = audioSeconds * sessions;
+
+    std::cout << "  peak RSS      " << std::setprecision(1) << rssStart << " MB at start, " << rssModel
+              << " MB with model, " << rssSessions << " MB with sessions ("
+              << (rssSessions - rssModel) / sessions << " MB per session)" << std::endl;
+    std::cout << "  peak RSS end  " << peakRssMb() << " MB" << std::endl;
+    std::cout << "  chunks        " << stats.chunksProcessed << " (" << results.load() << " with text)" << std::endl;
+    std::cout << std::setprecision(3);
+    std::cout << "  wall          " << wallSeconds << " s for " << totalAudio << " s of audio" << std::endl;
+    std::cout << "  aggregate RTF " << (totalAudio > 0.0 ? wallSeconds / totalAudio : 0.0)
+              << " (worker busy RTF " << (stats.audioSeconds > 0.0 ? stats.busySeconds / stats.audioSeconds : 0.0) << ")"
+              << std::endl;
+    return 0;
+}
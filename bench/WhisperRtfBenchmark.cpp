@@ -0,0 +1,148 @@
+/**
+ * @file WhisperRtfBenchmark.cpp
+ * @brief Real-time factor of whisper_full for 2/5/10 s chunks, default vs. low-latency profile
+ *
+ * Both profiles run on the same loaded model (the bridge shares the weights).
+ * RTF is decode time divided by audio duration; below 1.0 keeps up with live
+ * audio. Without an input file a synthetic voiced signal is used, which is
+ * enough to compare encoder cost but not transcription quality.
+ *
+ * Usage:
+ *   ./bench-whisper-rtf <model_path> [input.wav|-] [repeats] [threads]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FileAudioSource.h"
+#include "WhisperBridge.h"
+
+namespace
+{
+    /**
+     * @brief Pulsed harmonic tone with syllable-rate amplitude modulation
+     */
+    std::vector<float> syntheticVoice(size_t samples)
+    {
+        std::vector<float> audio(samples);
+        const double pi = 3.14159265358979323846;
+        for (size_t i = 0; i < samples; i++)
+        {
+            const double t = static_cast<double>(i) / 16000.0;
+            const double f0 = 140.0 + 30.0 * std::sin(2.0 * pi * 0.7 * t);
+            double v = 0.0;
+            for (int h = 1; h <= 8; h++)
+            {
+                v += std::sin(2.0 * pi * f0 * h * t) / h;
+            }
+            const double envelope = 0.5 + 0.5 * std::sin(2.0 * pi * 4.0 * t);
+            audio[i] = static_cast<float>(0.1 * envelope * v);
+        }
+        return audio;
+    }
+
+    std::vector<float> loadAudio(const std::string &path)
+    {
+        FileAudioSource::Config config;
+        config.path = path;
+        config.maxSpeed = true;
+        FileAudioSource source(config);
+        if (!source.initialize())
+        {
+            return {};
+        }
+
+        std::vector<float> audio;
+        source.start([&audio](const AudioChunkHandle &chunk)
+                     { audio.insert(audio.end(), chunk->data(), chunk->data() + chunk->size()); });
+        while (source.isCapturing())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        source.stop();
+        return audio;
+    }
+
+    /**
+     * @brief Mean seconds per whisper_full call over repeats (after one warm-up call)
+     */
+    double timeChunk(whisper_bridge_context *ctx, const float *audio, size_t samples, int repeats)
+    {
+        whisper_bridge_result warm = whisper_bridge_transcribe_audio(ctx, audio, static_cast<int>(samples), 16000);
+        whisper_bridge_free_result(&warm);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++)
+        {
+            whisper_bridge_result result = whisper_bridge_transcribe_audio(ctx, audio, static_cast<int>(samples), 16000);
+            whisper_bridge_free_result(&result);
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repeats;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <model_path> [input.wav|-] [repeats] [threads]" << std::endl;
+        return 1;
+    }
+
+    const std::string input = argc > 2 ? argv[2] : "";
+    const int repeats = argc > 3 ? std::max(1, std::atoi(argv[3])) : 5;
+    const int threads = argc > 4 ? std::max(1, std::atoi(argv[4])) : 4;
+    const int chunkSeconds[] = {2, 5, 10};
+
+    std::vector<float> audio = input.empty() ? syntheticVoice(10 * 16000) : loadAudio(input);
+    if (audio.size() < 10 * 16000)
+    {
+        std::cerr << "Need at least 10 s of audio" << std::endl;
+        return 1;
+    }
+
+    whisper_bridge_params params = {};
+    params.model_path = argv[1];
+    params.language = "en";
+    params.threads = threads;
+    params.max_len_ms = 30000;
+
+    whisper_bridge_context *fullWindow = whisper_bridge_init(params);
+    params.profile = WHISPER_BRIDGE_PROFILE_LOW_LATENCY;
+    whisper_bridge_context *lowLatency = whisper_bridge_init(params);
+    if (!fullWindow || !lowLatency)
+    {
+        std::cerr << "Failed to load model: " << argv[1] << std::endl;
+        whisper_bridge_free(fullWindow);
+        whisper_bridge_free(lowLatency);
+        return 1;
+    }
+
+    std::cout << "Whisper RTF benchmark: " << (input.empty() ? "synthetic audio" : input) << ", "
+              << threads << " threads, " << repeats << " runs per point" << std::endl;
+    std::cout << "  chunk      default RTF   low-latency RTF   speedup" << std::endl;
+
+    for (int seconds : chunkSeconds)
+    {
+        const size_t samples = static_cast<size_t>(seconds) * 16000;
+        const double full = timeChunk(fullWindow, audio.data(), samples, repeats);
+        const double fast = timeChunk(lowLatency, audio.data(), samples, repeats);
+
+        std::cout << "  " << std::setw(3) << seconds << " s  "
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(14) << full / seconds
+                  << std::setw(18) << fast / seconds
+                  << std::setw(9) << std::setprecision(1) << full / fast << "x" << std::endl;
+    }
+
+    whisper_bridge_free(lowLatency);
+    whisper_bridge_free(fullWindow);
+    return 0;
+}
@@ -1,20 +1,23 @@
 #pragma once
 
 #include <vector>
-#include <mutex>
 #include <memory>
 
+#include "SpscRingBuffer.h"
+
 /**
  * @brief Thread-safe circular buffer for audio data
  *
  * Provides a lock-free ring buffer optimized for real-time audio processing.
+ * Wraps SpscRingBuffer: exactly one thread may write and one thread may read.
+ * The size is rounded up to the next power of two.
  */
 class AudioBuffer
 {
 public:
     /**
      * @brief Constructor
-     * @param sizeInSamples Buffer size in audio samples
+     * @param sizeInSamples Minimum buffer size in audio samples
      */
     explicit AudioBuffer(size_t sizeInSamples);
 
@@ -24,7 +27,7 @@ public:
     ~AudioBuffer() = default;
 
     /**
-     * @brief Write audio data to the buffer
+     * @brief Write audio data to the buffer (producer thread only)
      * @param data Pointer to audio data
      * @param numSamples Number of samples to write
      * @return Number of samples actually written
@@ -32,7 +35,7 @@ public:
     size_t write(const float *data, size_t numSamples);
 
     /**
-     * @brief Read audio data from the buffer
+     * @brief Read audio data from the buffer (consumer thread only)
      * @param data Pointer to output buffer
      * @param numSamples Number of samples to read
      * @return Number of samples actually read
@@ -64,7 +67,7 @@ public:
     bool isFull() const;
 
     /**
-     * @brief Clear all data from the buffer
+     * @brief Clear all data from the buffer (consumer thread only)
      */
     void clear();
 
@@ -75,17 +78,5 @@ public:
     size_t getSize() const;
 
 private:
-    std::vector<float> buffer_;
-    size_t size_;
-    mutable std::mutex mutex_;
-    size_t writeIndex_;
-    size_t readIndex_;
-    size_t availableSamples_;
-
-    /**
-     * @brief Get next index in circular buffer
-     * @param index Current index
-     * @return Next index (wrapped around if necessary)
-     */
-    size_t nextIndex(size_t index) const;
-};
\ No newline at end of file
+    SpscRingBuffer<float> ring_;
+};
@@ -5,6 +5,7 @@
 #include <functional>
 #include <atomic>
 #include <thread>
+#include <cstdint>
 
 #include "RtAudio.h"
 
@@ -12,15 +13,20 @@
 #include "portaudio.h"
 #endif
 
+#include "AudioSource.h"
 #include "AudioBuffer.h"
+#include "SampleConverter.h"
+#include "Resampler.h"
 
 /**
  * @brief Cross-platform audio capture class using RtAudio or PortAudio
  *
  * Handles real-time audio capture from the system's default input device.
  * Automatically converts audio to the format required by Whisper (16kHz, mono, float32).
+ * Devices that cannot open at 16kHz are opened at their native rate and
+ * resampled on the dispatcher thread.
  */
-class AudioCapture
+class AudioCapture : public AudioSource
 {
 public:
     /**
@@ -28,10 +34,13 @@ public:
      */
     struct Config
     {
-        unsigned int sampleRate = 16000; ///< Target sample rate for Whisper
-        unsigned int channels = 1;       ///< Mono audio
-        unsigned int bufferSize = 128;   ///< Audio buffer size in frames
-        unsigned int deviceId = 0;       ///< Audio device ID (0 = default)
+        unsigned int sampleRate = 16000;   ///< Target sample rate for Whisper
+        unsigned int channels = 1;         ///< Mono audio
+        unsigned int bufferSize = 128;     ///< Audio buffer size in frames
+        unsigned int deviceId = 0;         ///< Audio device ID (0 = default)
+        unsigned int dispatchFrameMs = 20; ///< Frame length delivered by the dispatcher thread
+        SampleFormat sampleFormat = SampleFormat::Float32; ///< Format requested from the device (Int16 halves bytes per callback)
+        unsigned int deviceSampleRate = 0; ///< Rate to open the device at (0 = sampleRate if supported, else the device default)
 
         /**
          * @brief Default constructor
@@ -41,10 +50,11 @@ public:
 
     /**
      * @brief Callback function type for processed audio data
-     * @param audioData Vector of float samples (mono, 16kHz)
-     * @param timestamp Timestamp when audio was captured
+     *
+     * The callback runs on the dispatcher thread with fixed-size frames; the audio
+     * driver thread only fills the ring, without locks or allocation.
      */
-    using AudioCallback = std::function<void(const std::vector<float> &, double)>;
+    using AudioCallback = AudioSource::AudioCallback;
 
     /**
      * @brief Default constructor with default configuration
@@ -60,31 +70,31 @@ public:
     /**
      * @brief Destructor
      */
-    ~AudioCapture();
+    ~AudioCapture() override;
 
     /**
      * @brief Initialize the audio capture system
      * @return true on success, false on failure
      */
-    bool initialize();
+    bool initialize() override;
 
     /**
      * @brief Start audio capture
      * @param callback Function to call with captured audio data
      * @return true on success, false on failure
      */
-    bool start(AudioCallback callback);
+    bool start(AudioCallback callback) override;
 
     /**
      * @brief Stop audio capture
      */
-    void stop();
+    void stop() override;
 
     /**
      * @brief Check if audio capture is currently active
      * @return true if capturing, false otherwise
      */
-    bool isCapturing() const;
+    bool isCapturing() const override;
 
     /**
      * @brief Get list of available audio input devices
@@ -104,12 +114,47 @@ public:
      */
     void printAvailableDevices() const;
 
+    /**
+     * @brief Get the number of samples dropped because the ring buffer was full
+     * @return Dropped sample count since start()
+     */
+    uint64_t getDroppedSamples() const;
+
+    /**
+     * @brief Get the number of callbacks that reported an overflow/underflow
+     * @return Xrun count since start()
+     */
+    uint64_t getXrunCount() const;
+
+    /**
+     * @brief Get the rate the device stream was opened at
+     * @return Device sample rate (equal to Config::sampleRate when no resampling is needed)
+     */
+    unsigned int getStreamSampleRate() const;
+
 private:
     Config config_;
     AudioCallback callback_;
     std::atomic<bool> isCapturing_;
     std::unique_ptr<AudioBuffer> audioBuffer_;
 
+    // Dispatcher mode: the driver callback writes to audioBuffer_, this thread reads it
+    std::thread dispatcherThread_;
+    std::atomic<bool> dispatcherRunning_;
+    std::vector<float> scratch_;       ///< Preallocated downmix buffer used on the driver thread
+    std::unique_ptr<AudioChunkPool> chunkPool_; ///< Frames handed to the callback; consumers keep them by handle
+    AudioChunkHandle dispatchFrame_;            ///< Frame being filled, replaced from the pool after delivery
+    size_t frameSamples_;                       ///< Samples per delivered frame
+    std::atomic<double> streamStartTime_;
+    std::atomic<uint64_t> droppedSamples_;
+    std::atomic<uint64_t> xrunCount_;
+
+    // Native-rate devices: the ring holds device-rate audio, the dispatcher resamples it
+    unsigned int streamRate_;
+    std::unique_ptr<Resampler> resampler_;
+    std::vector<float> resampleInput_;
+    std::vector<float> resampleOutput_;
+
 #ifdef USE_RTAUDIO
     std::unique_ptr<RtAudio> rtAudio_;
 
@@ -155,19 +200,52 @@ private:
 #endif
 
     /**
-     * @brief Process raw audio data and convert to required format
+     * @brief Prepare ring and resampler for the rate the device will be opened at
+     * @param deviceRate Device sample rate
+     * @return false if the rate cannot be converted to Config::sampleRate
+     */
+    bool configureStreamRate(unsigned int deviceRate);
+
+    /**
+     * @brief Append samples to the outgoing frame, delivering each frame as it fills
+     * @param samples Mono samples at Config::sampleRate
+     * @param count Number of samples
+     * @param filled Samples already in dispatchFrame_ (updated)
+     * @param dispatchedSamples Samples delivered so far (updated)
+     */
+    void appendToFrame(const float *samples, size_t count, size_t &filled, uint64_t &dispatchedSamples);
+
+    /**
+     * @brief Hand dispatchFrame_ to the callback with its stream timestamp, then take a fresh frame
+     * @param dispatchedSamples Samples delivered so far (updated)
+     */
+    void deliverFrame(uint64_t &dispatchedSamples);
+
+    /**
+     * @brief Start the dispatcher thread (dispatcher mode only)
+     */
+    void startDispatcher();
+
+    /**
+     * @brief Stop the dispatcher thread after delivering any buffered audio
+     */
+    void stopDispatcher();
+
+    /**
+     * @brief Dispatcher thread: drain the ring in fixed frames and call the callback
+     */
+    void dispatcherThreadFunction();
+
+    /**
+     * @brief Driver-thread path: downmix into the ring without locks or allocation
      * @param inputBuffer Raw audio data
      * @param frames Number of audio frames
      * @param timestamp Audio timestamp
      */
-    void processAudioData(const void *inputBuffer, unsigned int frames, double timestamp);
+    void pushToRing(const void *inputBuffer, unsigned int frames, double timestamp);
 
     /**
-     * @brief Convert audio samples to float format
-     * @param input Input samples (various formats)
-     * @param frames Number of frames
-     * @param format Input sample format
-     * @return Vector of float samples
+     * @brief Record a driver-reported overflow/underflow
      */
-    std::vector<float> convertToFloat(const void *input, unsigned int frames, int format) const;
+    void reportXrun(unsigned long flags);
 };
\ No newline at end of file
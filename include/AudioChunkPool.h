@@ -0,0 +1,238 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct AudioChunkPoolState;
+
+/**
+ * @brief Pooled block of mono float audio with an intrusive reference count
+ *
+ * Chunks are only created by AudioChunkPool and are passed around through
+ * AudioChunkHandle. When the last handle goes away the chunk returns to its
+ * pool with its storage intact, so steady-state streaming allocates nothing.
+ */
+class AudioChunk
+{
+public:
+    AudioChunk(const AudioChunk &) = delete;
+    AudioChunk &operator=(const AudioChunk &) = delete;
+
+    float *data() { return samples_.get(); }
+    const float *data() const { return samples_.get(); }
+
+    /**
+     * @brief Number of valid samples
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Number of samples the storage can hold
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Timestamp of data()[0] in seconds
+     */
+    double timestamp() const { return timestamp_; }
+
+    /**
+     * @brief Set the number of valid samples (at most capacity())
+     */
+    void resize(size_t count) { size_ = count < capacity_ ? count : capacity_; }
+
+    void setTimestamp(double timestamp) { timestamp_ = timestamp; }
+
+private:
+    friend class AudioChunkPool;
+    friend class AudioChunkHandle;
+
+    AudioChunk() : pool_(nullptr), refs_(0), capacity_(0), size_(0), timestamp_(0.0) {}
+
+    AudioChunkPoolState *pool_;
+    std::atomic<uint32_t> refs_;
+    std::unique_ptr<float[]> samples_;
+    size_t capacity_;
+    size_t size_;
+    double timestamp_;
+};
+
+/**
+ * @brief Shared reference to a pooled AudioChunk
+ *
+ * Copying a handle bumps the reference count; no samples are copied. Handles
+ * may be released on any thread.
+ */
+class AudioChunkHandle
+{
+public:
+    AudioChunkHandle() noexcept : chunk_(nullptr) {}
+
+    AudioChunkHandle(const AudioChunkHandle &other) noexcept : chunk_(other.chunk_)
+    {
+        if (chunk_)
+        {
+            chunk_->refs_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    AudioChunkHandle(AudioChunkHandle &&other) noexcept : chunk_(other.chunk_)
+    {
+        other.chunk_ = nullptr;
+    }
+
+    AudioChunkHandle &operator=(AudioChunkHandle other) noexcept
+    {
+        std::swap(chunk_, other.chunk_);
+        return *this;
+    }
+
+    ~AudioChunkHandle()
+    {
+        reset();
+    }
+
+    /**
+     * @brief Drop this reference; the chunk returns to its pool when it was the last one
+     */
+    void reset();
+
+    AudioChunk *get() const { return chunk_; }
+    AudioChunk *operator->() const { return chunk_; }
+    AudioChunk &operator*() const { return *chunk_; }
+    explicit operator bool() const { return chunk_ != nullptr; }
+
+private:
+    friend class AudioChunkPool;
+
+    /**
+     * @brief Adopt a chunk whose reference count was already set for this handle
+     */
+    explicit AudioChunkHandle(AudioChunk *chunk) noexcept : chunk_(chunk) {}
+
+    AudioChunk *chunk_;
+};
+
+/**
+ * @brief Free list of reusable audio chunks
+ *
+ * acquire() takes the mutex briefly and only allocates when every chunk is in
+ * use (or a request is larger than any idle chunk). The pool may be destroyed
+ * while handles are still alive; the remaining chunks are freed when their
+ * last handle is released.
+ */
+class AudioChunkPool
+{
+public:
+    /**
+     * @brief Allocation counters
+     */
+    struct Stats
+    {
+        uint64_t acquired = 0;         ///< acquire() calls
+        size_t chunksAllocated = 0;    ///< Chunks ever created
+        size_t storageAllocations = 0; ///< Sample buffers allocated (new chunks and grown chunks)
+        size_t inUse = 0;              ///< Chunks currently referenced by a handle
+        size_t idle = 0;               ///< Chunks waiting in the free list
+    };
+
+    /**
+     * @brief Constructor
+     * @param chunkSamples Default chunk capacity in samples
+     * @param initialChunks Chunks allocated up front
+     */
+    explicit AudioChunkPool(size_t chunkSamples, size_t initialChunks = 0);
+
+    /**
+     * @brief Destructor; outstanding chunks stay valid until released
+     */
+    ~AudioChunkPool();
+
+    AudioChunkPool(const AudioChunkPool &) = delete;
+    AudioChunkPool &operator=(const AudioChunkPool &) = delete;
+
+    /**
+     * @brief Take a chunk from the pool
+     * @param samples Required capacity; size() is set to this value
+     * @return Handle to a chunk with timestamp 0
+     */
+    AudioChunkHandle acquire(size_t samples);
+
+    /**
+     * @brief Take a chunk and fill it with a copy of samples
+     */
+    AudioChunkHandle copyOf(const float *samples, size_t count, double timestamp);
+
+    /**
+     * @brief Get allocation counters
+     */
+    Stats getStats() const;
+
+private:
+    friend class AudioChunkHandle;
+
+    AudioChunkPoolState *state_;
+
+    /**
+     * @brief Return a chunk whose last handle was released
+     */
+    static void recycle(AudioChunk *chunk);
+};
+
+inline void AudioChunkHandle::reset()
+{
+    if (chunk_ && chunk_->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        AudioChunkPool::recycle(chunk_);
+    }
+    chunk_ = nullptr;
+}
+
+/**
+ * @brief FIFO of chunk handles on a ring that only grows
+ *
+ * Push and pop move handles without allocating once the ring has room for the
+ * largest backlog seen so far. Not thread-safe; callers hold their own lock.
+ */
+class AudioChunkQueue
+{
+public:
+    /**
+     * @brief Constructor
+     * @param initialCapacity Handles the ring holds before it first grows
+     */
+    explicit AudioChunkQueue(size_t initialCapacity = 64);
+
+    /**
+     * @brief Append a chunk
+     */
+    void push(AudioChunkHandle chunk);
+
+    /**
+     * @brief Remove the oldest chunk
+     * @param chunk Receives the chunk
+     * @return false if the queue is empty
+     */
+    bool pop(AudioChunkHandle &chunk);
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /**
+     * @brief Release all queued chunks (capacity is kept)
+     */
+    void clear();
+
+    /**
+     * @brief Exchange contents with another queue
+     */
+    void swap(AudioChunkQueue &other) noexcept;
+
+private:
+    std::vector<AudioChunkHandle> slots_;
+    size_t head_;
+    size_t count_;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+
+#include "AudioChunkPool.h"
+
+/**
+ * @brief Interface for anything that produces mono 16kHz float audio
+ *
+ * Implemented by AudioCapture (live devices) and FileAudioSource (WAV/raw PCM
+ * files and stdin), so the transcription pipeline does not care where audio
+ * comes from.
+ */
+class AudioSource
+{
+public:
+    /**
+     * @brief Callback function type for produced audio data
+     * @param chunk Pooled block of float samples (mono, 16kHz) and the timestamp of its first sample;
+     *              keep a copy of the handle to hold on to the audio without copying it
+     */
+    using AudioCallback = std::function<void(const AudioChunkHandle &)>;
+
+    virtual ~AudioSource() = default;
+
+    /**
+     * @brief Open the underlying device or file
+     * @return true on success, false on failure
+     */
+    virtual bool initialize() = 0;
+
+    /**
+     * @brief Start producing audio
+     * @param callback Function to call with each block of audio
+     * @return true on success, false on failure
+     */
+    virtual bool start(AudioCallback callback) = 0;
+
+    /**
+     * @brief Stop producing audio
+     */
+    virtual void stop() = 0;
+
+    /**
+     * @brief Check if the source is still producing audio
+     * @return false once stopped or, for finite sources, after the last block was delivered
+     */
+    virtual bool isCapturing() const = 0;
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+
+#include "AudioSource.h"
+#include "SampleConverter.h"
+#include "Resampler.h"
+
+/**
+ * @brief Audio source that streams a WAV or raw PCM recording
+ *
+ * Files are memory-mapped and converted straight out of the mapping; stdin
+ * ("-") is read in chunks. Audio is downmixed and resampled to 16kHz mono and
+ * delivered in fixed frames from a reader thread, either paced to real time or,
+ * in max-speed mode, as fast as the consumer keeps up (see setPendingSamplesProvider).
+ */
+class FileAudioSource : public AudioSource
+{
+public:
+    /**
+     * @brief Container format of the input
+     */
+    enum class InputFormat
+    {
+        Auto, ///< WAV if the stream starts with a RIFF/WAVE header, raw PCM otherwise
+        Wav,  ///< RIFF/WAVE (PCM 16/32-bit or IEEE float 32-bit)
+        Raw   ///< Headerless interleaved PCM described by the raw* fields
+    };
+
+    /**
+     * @brief Configuration for file/stdin input
+     */
+    struct Config
+    {
+        std::string path;                                 ///< Input file path, or "-" for stdin
+        InputFormat format = InputFormat::Auto;           ///< Container format
+        unsigned int rawSampleRate = 16000;               ///< Sample rate of raw input
+        unsigned int rawChannels = 1;                     ///< Interleaved channels of raw input
+        SampleFormat rawSampleFormat = SampleFormat::Int16; ///< Sample format of raw input
+        unsigned int sampleRate = 16000;                  ///< Output sample rate for Whisper
+        unsigned int frameMs = 20;                        ///< Frame length delivered to the callback
+        bool maxSpeed = false;                            ///< Deliver as fast as the consumer keeps up instead of in real time
+        size_t maxPendingSamples = 16000 * 20;            ///< Max-speed mode pauses while the consumer has more than this queued
+    };
+
+    /**
+     * @brief Constructor
+     * @param config Input configuration
+     */
+    explicit FileAudioSource(const Config &config);
+
+    /**
+     * @brief Destructor
+     */
+    ~FileAudioSource() override;
+
+    /**
+     * @brief Open the input and parse its header
+     * @return true on success, false on failure
+     */
+    bool initialize() override;
+
+    /**
+     * @brief Start the reader thread
+     * @param callback Function to call with each frame; runs on the reader thread
+     * @return true on success, false on failure
+     */
+    bool start(AudioCallback callback) override;
+
+    /**
+     * @brief Stop the reader thread
+     */
+    void stop() override;
+
+    /**
+     * @brief Check if the reader is still delivering audio
+     * @return false once stopped or after the end of input was delivered
+     */
+    bool isCapturing() const override;
+
+    /**
+     * @brief Set the flow-control query used in max-speed mode
+     * @param provider Returns the number of samples the consumer has not processed yet
+     *                 (e.g. WhisperTranscriber::getPendingSamples)
+     */
+    void setPendingSamplesProvider(std::function<size_t()> provider);
+
+    /**
+     * @brief Get the number of output samples delivered so far
+     */
+    uint64_t getSamplesDelivered() const;
+
+    /**
+     * @brief Get the input duration in seconds
+     * @return Duration, or a negative value when unknown (stdin)
+     */
+    double getDurationSeconds() const;
+
+private:
+    Config config_;
+    AudioCallback callback_;
+    std::function<size_t()> pendingProvider_;
+    std::thread readerThread_;
+    std::atomic<bool> running_;
+    std::atomic<bool> isCapturing_;
+    std::atomic<uint64_t> samplesDelivered_;
+    std::chrono::steady_clock::time_point startTime_; ///< Real-time pacing reference
+
+    // Input layout, from the WAV header or the raw* config fields
+    SampleFormat inputFormat_;
+    unsigned int inputRate_;
+    unsigned int inputChannels_;
+    size_t frameBytes_;
+
+    // Memory-mapped file input
+    int fd_;
+    const uint8_t *mapping_;
+    size_t mappingSize_;
+    size_t position_;  ///< Read offset in mapping_
+    size_t dataBegin_; ///< Start of the audio data in mapping_
+    size_t dataEnd_;   ///< End of the audio data in mapping_
+
+    // Stdin input
+    bool useStdin_;
+    std::vector<uint8_t> stdinBuffer_;
+    size_t stdinFill_; ///< Valid bytes in stdinBuffer_
+
+    std::unique_ptr<Resampler> resampler_;
+    std::vector<float> mono_;
+    std::vector<float> resampled_;
+    std::unique_ptr<AudioChunkPool> chunkPool_;
+    AudioChunkHandle frame_; ///< Frame being filled, replaced from the pool after delivery
+    size_t frameSamples_;    ///< Samples per delivered frame (0 until initialized)
+
+    /**
+     * @brief Memory-map the input file and locate the audio data
+     */
+    bool openFile();
+
+    /**
+     * @brief Detect the format on stdin and consume any WAV header
+     */
+    bool openStdin();
+
+    /**
+     * @brief Parse the chunks after the RIFF/WAVE tag up to the start of the data chunk
+     * @param read Reads exactly n bytes into dst (or skips them when dst is null)
+     * @param dataBytes Size of the data chunk as declared in the header
+     * @return true on success, false if the header is invalid or unsupported
+     */
+    bool parseWavHeader(const std::function<bool(void *, size_t)> &read, uint32_t &dataBytes);
+
+    /**
+     * @brief Check the input layout and prepare conversion buffers
+     */
+    bool prepareConversion();
+
+    /**
+     * @brief Read up to maxFrames whole frames from stdin into stdinBuffer_
+     * @return Number of frames available at the start of stdinBuffer_ (0 at end of input)
+     */
+    size_t readStdinFrames(size_t maxFrames);
+
+    /**
+     * @brief Reader thread: convert input blocks and deliver frames
+     */
+    void readerThreadFunction();
+
+    /**
+     * @brief Append samples to the outgoing frame, delivering each frame as it fills
+     * @param samples Mono samples at Config::sampleRate
+     * @param count Number of samples
+     * @param filled Samples already in frame_ (updated)
+     */
+    void appendToFrame(const float *samples, size_t count, size_t &filled);
+
+    /**
+     * @brief Pace or throttle, then hand frame_ to the callback and take a fresh frame
+     */
+    void deliverFrame();
+
+    /**
+     * @brief Release the file mapping
+     */
+    void closeInput();
+};
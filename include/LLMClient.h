@@ -3,6 +3,7 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <functional>
 
 // Forward declare llama types to avoid including llama.h in header
 struct llama_model;
@@ -22,11 +23,30 @@ public:
     {
         std::string modelPath;    ///< Path to GGUF model file
         int threads = 4;          ///< Number of threads for inference
-        int contextSize = 32768;  ///< Context window size
-        int maxTokens = 4096;     ///< Maximum tokens to generate
+        int contextSize = 16384;  ///< Context window size, shared by all sequences; long transcripts are summarized in chunks
+        int maxTokens = 4096;     ///< Maximum tokens to generate (never more than the context has room for)
         float temperature = 0.7f; ///< Sampling temperature
         float topP = 0.9f;        ///< Top-p sampling
         bool verbose = false;     ///< Enable verbose logging
+        bool prefaultModel = true; ///< Start reading the model file into the page cache before loading it
+        bool warmup = true;       ///< Decode one token during initialize()
+        bool cachePromptPrefixes = true; ///< Keep the KV state of the fixed summary and chat prompt heads
+        int maxSessions = 4;      ///< Chat sessions that can be open at once (each keeps its own KV cache sequence)
+        int batchSize = 0;        ///< Logical batch size (0 = llama.cpp default)
+        int ubatchSize = 0;       ///< Prompt tokens decoded per step (0 = llama.cpp default); see bench-llama-prefill
+        int summaryChunkTokens = 3072; ///< Longer transcripts are summarized as chunks of this size, in parallel (0 = one prompt)
+        int summaryNoteTokens = 512;   ///< Maximum tokens of notes per chunk
+        int summaryParallel = 4;       ///< Chunks summarized at once besides the stateless sequence (each keeps its own KV cache sequence)
+    };
+
+    /**
+     * @brief Where startup time went
+     */
+    struct StartupTimeline
+    {
+        double loadMs = 0.0;         ///< initialize(): model and context creation
+        double warmupMs = 0.0;       ///< initialize(): warm-up decode and prompt prefix caching
+        double firstResultMs = -1.0; ///< Duration of the first request (-1 = none yet)
     };
 
     /**
@@ -34,13 +54,26 @@ public:
      */
     struct Response
     {
-        std::string text;       ///< Generated text
-        int tokensGenerated;    ///< Number of tokens generated
-        double inferenceTimeMs; ///< Inference time in milliseconds
-        bool success;           ///< Whether generation was successful
-        std::string error;      ///< Error message if failed
+        std::string text{};              ///< Generated text
+        int tokensGenerated = 0;         ///< Number of tokens generated
+        double inferenceTimeMs = 0.0;    ///< Inference time in milliseconds
+        double timeToFirstTokenMs = 0.0; ///< Prompt evaluation up to the first generated token
+        int promptTokens = 0;            ///< Tokens in the prompt
+        int cachedPromptTokens = 0;      ///< Prompt tokens restored from the KV cache instead of prefilled
+        bool success = false;            ///< Whether generation was successful
+        std::string error{};             ///< Error message if failed
     };
 
+    /**
+     * @brief Receives generated text as it is produced; return false to stop generating
+     */
+    using TokenCallback = std::function<bool(const std::string &piece)>;
+
+    /**
+     * @brief Receives prompt prefill progress: tokens in the KV cache so far and the prompt length
+     */
+    using ProgressCallback = std::function<void(int done, int total)>;
+
     /**
      * @brief Constructor
      * @param config LLM configuration
@@ -60,18 +93,65 @@ public:
 
     /**
      * @brief Summarize a transcript
+     *
+     * A transcript longer than summaryChunkTokens is split into chunks that are condensed into notes
+     * together in one batched decode loop; the sectioned summary is then written from the notes.
+     *
      * @param transcript The transcript text to summarize
+     * @param onToken Optional callback streaming the summary as it is generated
      * @return LLM response with summary
      */
-    Response summarizeTranscript(const std::string &transcript);
+    Response summarizeTranscript(const std::string &transcript, TokenCallback onToken = nullptr);
 
     /**
      * @brief Chat with context from transcripts
      * @param question User's question
      * @param context Relevant transcript context
+     * @param onToken Optional callback streaming the answer as it is generated
      * @return LLM response
      */
-    Response chatWithContext(const std::string &question, const std::string &context);
+    Response chatWithContext(const std::string &question, const std::string &context, TokenCallback onToken = nullptr);
+
+    /**
+     * @brief Open a chat session that keeps its conversation in the KV cache between questions
+     * @return Session id, or -1 if not initialized or maxSessions are open
+     */
+    int createSession();
+
+    /**
+     * @brief Open a new session continuing from the current state of another one
+     * @param session Session to branch from
+     * @return Session id, or -1 on failure
+     */
+    int forkSession(int session);
+
+    /**
+     * @brief Forget the conversation of a session, keeping it open
+     * @param session Session id
+     * @return false if the session is not open
+     */
+    bool resetSession(int session);
+
+    /**
+     * @brief Close a session and free its KV cache cells
+     * @param session Session id
+     */
+    void destroySession(int session);
+
+    /**
+     * @brief Ask the next question in a session; only the new message is prefilled
+     * @param session Session id from createSession() or forkSession()
+     * @param message User's message (put any transcript context in the first one)
+     * @param onToken Optional callback streaming the answer as it is generated
+     * @return LLM response
+     */
+    Response chatInSession(int session, const std::string &message, TokenCallback onToken = nullptr);
+
+    /**
+     * @brief Report prompt prefill progress of every following request (long transcripts take a while)
+     * @param callback Progress callback, or nullptr to stop reporting
+     */
+    void setPrefillProgressCallback(ProgressCallback callback);
 
     /**
      * @brief Check if LLM is initialized
@@ -79,28 +159,56 @@ public:
      */
     bool isInitialized() const;
 
+    /**
+     * @brief Get the load, warm-up and first-result latencies
+     */
+    StartupTimeline getStartupTimeline() const;
+
 private:
     Config config_;
     llama_model *model_;     // Forward declared, defined in .cpp
     llama_context *context_; // Forward declared, defined in .cpp
     bool initialized_;
+    StartupTimeline startup_;
+    ProgressCallback prefillProgress_;
 
     /**
      * @brief Generate text using the model
      * @param prompt Input prompt
      * @param maxTokens Maximum tokens to generate
+     * @param onToken Optional streaming callback
      * @return LLM response
      */
-    Response generate(const std::string &prompt, int maxTokens = -1);
+    Response generate(const std::string &prompt, int maxTokens = -1, TokenCallback onToken = nullptr);
 
     /**
      * @brief Chat with system and user messages (Qwen format)
      * @param system_prompt System prompt for context
      * @param user_message User's message
      * @param maxTokens Maximum tokens to generate
+     * @param onToken Optional streaming callback
      * @return LLM response
      */
-    Response chat(const std::string &system_prompt, const std::string &user_message, int maxTokens = -1);
+    Response chat(const std::string &system_prompt, const std::string &user_message, int maxTokens = -1,
+                  TokenCallback onToken = nullptr);
+
+    /**
+     * @brief Run chat requests with a shared system prompt in parallel KV cache sequences
+     * @param system_prompt System prompt for all requests
+     * @param user_messages One user message per request
+     * @param maxTokens Maximum tokens to generate per request
+     * @return One response per message, in order
+     */
+    std::vector<Response> chatBatch(const std::string &system_prompt, const std::vector<std::string> &user_messages,
+                                    int maxTokens);
+
+    /**
+     * @brief Split tokens into text chunks of at most chunkTokens, preferably at sentence ends
+     * @param tokens Tokenized text
+     * @param chunkTokens Maximum tokens per chunk
+     * @return Chunk texts in order
+     */
+    std::vector<std::string> splitIntoChunks(const std::vector<llama_token> &tokens, int chunkTokens);
 
     /**
      * @brief Tokenize text
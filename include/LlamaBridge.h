@@ -16,6 +16,11 @@ typedef struct {
     float temperature;
     float top_p;
     bool verbose;
+    bool prefault;             // Start reading the model file into the page cache (madvise WILLNEED) before loading
+    int max_sessions;          // Sessions that can be open at once (each is a KV cache sequence); 0 for none
+    int max_parallel;          // KV cache sequences reserved for batched generation, besides sequence 0; 0 for none
+    int batch_size;            // Logical batch size n_batch (0 = llama.cpp default)
+    int ubatch_size;           // Physical batch size n_ubatch; prompts are prefilled in slices of this size (0 = default)
 } llama_bridge_params;
 
 // Result structure (plain C types only)
@@ -23,6 +28,9 @@ typedef struct {
     char* text;                 // Allocated string - caller must free
     int tokens_generated;
     double inference_time_ms;
+    double time_to_first_token_ms; // Prompt evaluation up to the first sampled token
+    int prompt_tokens;          // Tokens in the prompt
+    int prompt_tokens_cached;   // Leading prompt tokens taken from the KV cache instead of prefilled
     bool success;
     char* error_msg;           // Allocated string - caller must free on error
 } llama_bridge_result;
@@ -37,6 +45,10 @@ typedef struct {
 llama_bridge_context* llama_bridge_init(llama_bridge_params params);
 void llama_bridge_free(llama_bridge_context* ctx);
 
+// Decode a single token and clear the KV cache again, so the first real request does not pay for
+// compute buffer allocation, backend initialization and cold weight pages
+bool llama_bridge_warmup(llama_bridge_context* ctx);
+
 llama_bridge_result llama_bridge_generate(
     llama_bridge_context* ctx,
     const char* prompt,
@@ -50,6 +62,102 @@ llama_bridge_result llama_bridge_chat(
     int max_tokens
 );
 
+// Prefix cache: decode a prompt prefix once and keep a snapshot of its KV state. A later prompt that
+// starts with the same tokens restores the snapshot and prefills only the rest (the tokens left in
+// the KV cache by the previous call are reused the same way). Returns false if it could not be decoded.
+bool llama_bridge_cache_prefix(llama_bridge_context* ctx, const char* prefix);
+
+// Same for llama_bridge_chat prompts: the system prompt and the start of the user message
+bool llama_bridge_cache_chat_prefix(llama_bridge_context* ctx, const char* system_prompt, const char* user_prefix);
+
+// Streaming variants: callback receives the generated text piece by piece as it is sampled
+// (never split inside a UTF-8 character or a stop sequence; pieces are not NUL-terminated).
+// Return false from the callback to stop generating. The result still holds the whole text.
+typedef bool (*llama_bridge_token_callback)(const char* piece, int length, void* user_data);
+
+llama_bridge_result llama_bridge_generate_stream(
+    llama_bridge_context* ctx,
+    const char* prompt,
+    int max_tokens,
+    llama_bridge_token_callback callback,
+    void* user_data
+);
+
+llama_bridge_result llama_bridge_chat_stream(
+    llama_bridge_context* ctx,
+    const char* system_prompt,
+    const char* user_message,
+    int max_tokens,
+    llama_bridge_token_callback callback,
+    void* user_data
+);
+
+// Sessions: each one is a KV cache sequence of the shared context that keeps its tokens between
+// calls, so a conversation or a series of requests on the same text only prefills what is new.
+// Sequence 0 stays with the calls above. A session id is valid until it is destroyed; -1 is no session.
+typedef int llama_bridge_session;
+
+// Open an empty session; -1 when max_sessions are already open
+llama_bridge_session llama_bridge_session_create(llama_bridge_context* ctx);
+
+// Drop everything the session holds; it stays open and starts again at position 0
+bool llama_bridge_session_reset(llama_bridge_context* ctx, llama_bridge_session session);
+
+// Open a new session holding the same tokens (the KV cells are shared, not copied); -1 on failure
+llama_bridge_session llama_bridge_session_fork(llama_bridge_context* ctx, llama_bridge_session session);
+
+// Free the session's KV cells and its id
+void llama_bridge_session_destroy(llama_bridge_context* ctx, llama_bridge_session session);
+
+// Tokens in the session, i.e. the position its next token is decoded at; -1 for an invalid session
+int llama_bridge_session_position(llama_bridge_context* ctx, llama_bridge_session session);
+
+// Append prompt to the session and generate; the generated tokens stay in the session too
+llama_bridge_result llama_bridge_session_generate(
+    llama_bridge_context* ctx,
+    llama_bridge_session session,
+    const char* prompt,
+    int max_tokens,
+    llama_bridge_token_callback callback,
+    void* user_data
+);
+
+// Next chat turn in the session: the system prompt is used on the first turn only
+llama_bridge_result llama_bridge_session_chat(
+    llama_bridge_context* ctx,
+    llama_bridge_session session,
+    const char* system_prompt,
+    const char* user_message,
+    int max_tokens,
+    llama_bridge_token_callback callback,
+    void* user_data
+);
+
+// Batched generation: every prompt gets its own KV cache sequence and all sequences in flight are
+// decoded together, one llama_decode per step carrying the next token of each (prompts are prefilled
+// in the same steps). Sequence 0 and the max_parallel batch sequences serve as slots, so up to
+// max_parallel + 1 prompts run at once however many sessions are open; further prompts wait for a
+// free slot and for room in the context, which keeps memory bounded however many there are. results must hold count entries, each
+// to be freed with llama_bridge_free_result. Prefill progress covers all prompts together.
+// Returns false on invalid parameters; per-prompt failures are reported in results.
+bool llama_bridge_generate_batch(
+    llama_bridge_context* ctx,
+    const char* const* prompts,
+    int count,
+    int max_tokens,
+    llama_bridge_result* results
+);
+
+// Same with one system prompt for all user messages
+bool llama_bridge_chat_batch(
+    llama_bridge_context* ctx,
+    const char* system_prompt,
+    const char* const* user_messages,
+    int count,
+    int max_tokens,
+    llama_bridge_result* results
+);
+
 void llama_bridge_free_result(llama_bridge_result* result);
 
 // Advanced tokenization functions
@@ -57,6 +165,11 @@ llama_bridge_tokens llama_bridge_tokenize(llama_bridge_context* ctx, const char*
 char* llama_bridge_detokenize(llama_bridge_context* ctx, const llama_bridge_tokens* tokens);
 void llama_bridge_free_tokens(llama_bridge_tokens* tokens);
 
+// Prefill progress: called before the first prompt slice is decoded and after each one, with the
+// prompt tokens in the KV cache so far (restored ones included) and the prompt length
+typedef void (*llama_bridge_progress_callback)(int done, int total, void* user_data);
+void llama_bridge_set_progress_callback(llama_bridge_context* ctx, llama_bridge_progress_callback callback, void* user_data);
+
 // Utility functions
 int llama_bridge_get_context_size(llama_bridge_context* ctx);
 int llama_bridge_get_vocab_size(llama_bridge_context* ctx);
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Streaming polyphase FIR resampler
+ *
+ * Converts mono float audio from a device's native rate to the rate Whisper
+ * expects. Filter banks are Blackman-Harris windowed sinc prototypes evaluated at
+ * compile time for each supported rate pair; the per-output dot product runs
+ * on AVX2, SSE2 or NEON. Filter state is carried across process() calls so
+ * chunk boundaries are seamless.
+ *
+ * Supported input rates (to 16 kHz): 8000, 22050, 24000, 32000, 44100, 48000, 96000.
+ */
+class Resampler
+{
+public:
+    /**
+     * @brief Constructor
+     * @param inputRate Device sample rate
+     * @param outputRate Target sample rate
+     * @param maxInputChunk Largest input chunk expected per process() call (for preallocation)
+     */
+    Resampler(unsigned int inputRate, unsigned int outputRate, size_t maxInputChunk = 4096);
+
+    /**
+     * @brief Check whether a rate pair has a precomputed filter bank
+     */
+    static bool isSupported(unsigned int inputRate, unsigned int outputRate);
+
+    /**
+     * @brief Check whether this instance has a valid filter bank
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Resample a chunk of input
+     * @param input Input samples at the input rate
+     * @param numSamples Number of input samples
+     * @param output Destination buffer, at least maxOutputFor(numSamples) samples
+     * @param outputCapacity Size of the destination buffer
+     * @return Number of output samples written
+     */
+    size_t process(const float *input, size_t numSamples, float *output, size_t outputCapacity);
+
+    /**
+     * @brief Drain the filter at end of input
+     *
+     * Feeds the filter's group delay worth of zeros, so the output covering the
+     * last input samples is emitted, then clears the filter history.
+     * @param output Destination buffer, at least maxOutputFor(getTapsPerPhase()) samples
+     * @param outputCapacity Size of the destination buffer
+     * @return Number of output samples written
+     */
+    size_t flush(float *output, size_t outputCapacity);
+
+    /**
+     * @brief Upper bound on the output produced by one process() call
+     */
+    size_t maxOutputFor(size_t numSamples) const;
+
+    /**
+     * @brief Clear filter history
+     */
+    void reset();
+
+    unsigned int getInputRate() const { return inputRate_; }
+    unsigned int getOutputRate() const { return outputRate_; }
+
+    /**
+     * @brief Filter taps evaluated per output sample
+     */
+    size_t getTapsPerPhase() const { return taps_; }
+
+private:
+    unsigned int inputRate_;
+    unsigned int outputRate_;
+    unsigned int up_;             ///< Interpolation factor L
+    unsigned int down_;           ///< Decimation factor M
+    size_t taps_;                 ///< Taps per polyphase branch
+    const float *bank_;           ///< up_ branches of taps_ coefficients, time-reversed
+    std::vector<float> history_;  ///< taps_ - 1 samples of history followed by pending input
+    size_t newest_;               ///< Index in history_ of the newest input sample for the next output
+    unsigned int phase_;          ///< Current polyphase branch
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Chooses a degradation level from the measured real-time factor
+ *
+ * Each decode reports how long it took for how much audio. The smoothed
+ * real-time factor (decode time / audio time) above highRtf steps the level
+ * down one rung of the caller's ladder (cheaper decoding); below lowRtf it
+ * steps back up. After every change the governor waits settleDecodes decodes
+ * so the effect of the new level is measured before the next decision.
+ */
+class RtfGovernor
+{
+public:
+    /**
+     * @brief Configuration for the governor
+     */
+    struct Config
+    {
+        double highRtf = 1.0;   ///< Degrade further while the smoothed RTF is above this
+        double lowRtf = 0.5;    ///< Restore one level while the smoothed RTF is below this
+        double smoothing = 0.3; ///< Weight of the newest decode in the moving average
+        int maxLevel = 0;       ///< Number of degradation steps available (0 = never degrade)
+        int settleDecodes = 2;  ///< Decodes to wait after a level change
+    };
+
+    /**
+     * @brief Constructor
+     * @param config Governor configuration
+     */
+    explicit RtfGovernor(const Config &config);
+
+    /**
+     * @brief Record one decode
+     * @param audioSeconds Duration of the decoded audio
+     * @param decodeSeconds Wall time the decode took
+     * @return Level to run the next decode at (0 = undegraded)
+     */
+    int update(double audioSeconds, double decodeSeconds);
+
+    /**
+     * @brief Current degradation level
+     */
+    int level() const { return level_; }
+
+    /**
+     * @brief Smoothed real-time factor (0 before the first decode)
+     */
+    double rtf() const { return rtf_; }
+
+    /**
+     * @brief Level changes towards cheaper decoding so far
+     */
+    uint64_t stepsDown() const { return stepsDown_; }
+
+    /**
+     * @brief Level changes back towards the configured decoding so far
+     */
+    uint64_t stepsUp() const { return stepsUp_; }
+
+    /**
+     * @brief Return to level 0 and forget the measurements
+     */
+    void reset();
+
+private:
+    Config config_;
+    int level_;
+    double rtf_;
+    bool measured_;
+    int settleLeft_;
+    uint64_t stepsDown_;
+    uint64_t stepsUp_;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Sample formats a capture device can deliver
+ */
+enum class SampleFormat
+{
+    Float32, ///< 32-bit float in [-1, 1]
+    Int16,   ///< Signed 16-bit PCM
+    Int32    ///< Signed 32-bit PCM
+};
+
+/**
+ * @brief Vectorized sample-format conversion and downmix
+ *
+ * Converts interleaved device samples to mono float32 in a single pass into a
+ * caller-provided buffer. The kernel set (AVX2, SSE2, NEON or scalar) is chosen
+ * once at startup from the CPU features of the host. 1, 2, 4 and 8 channel
+ * layouts are vectorized; other channel counts use the scalar path.
+ */
+class SampleConverter
+{
+public:
+    /**
+     * @brief Convert and downmix interleaved frames to mono float
+     * @param input Interleaved samples in the given format
+     * @param format Input sample format
+     * @param frames Number of frames (samples per channel)
+     * @param channels Number of interleaved channels
+     * @param output Destination for frames mono samples
+     * @note Never allocates or locks; safe to call on the audio driver thread
+     */
+    static void toMono(const void *input, SampleFormat format, size_t frames, unsigned int channels, float *output);
+
+    /**
+     * @brief Bytes per sample for a format
+     */
+    static size_t bytesPerSample(SampleFormat format);
+
+    /**
+     * @brief Name of the kernel set selected for this CPU ("avx2", "sse2", "neon" or "scalar")
+     */
+    static const char *backendName();
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <algorithm>
+
+/**
+ * @brief Wait-free single-producer/single-consumer ring buffer
+ *
+ * One thread may call write() and one other thread may call read()
+ * concurrently without any locking. Capacity is rounded up to a power of two
+ * so index wrapping is a mask, and wrap-around is handled with at most two
+ * memcpy calls per operation.
+ *
+ * @tparam T Trivially copyable element type
+ */
+template <typename T>
+class SpscRingBuffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRingBuffer requires a trivially copyable type");
+
+public:
+    /**
+     * @brief Constructor
+     * @param minCapacity Minimum number of elements; rounded up to a power of two
+     */
+    explicit SpscRingBuffer(size_t minCapacity)
+        : capacity_(roundUpPowerOfTwo(minCapacity)), mask_(capacity_ - 1), buffer_(new T[capacity_]())
+    {
+    }
+
+    SpscRingBuffer(const SpscRingBuffer &) = delete;
+    SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+    /**
+     * @brief Write elements to the buffer (producer thread only)
+     * @param data Pointer to elements
+     * @param count Number of elements to write
+     * @return Number of elements actually written
+     */
+    size_t write(const T *data, size_t count)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        size_t free = capacity_ - (head - cachedTail_);
+        if (free < count)
+        {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            free = capacity_ - (head - cachedTail_);
+        }
+
+        const size_t toWrite = std::min(count, free);
+        if (toWrite == 0)
+        {
+            return 0;
+        }
+
+        const size_t offset = head & mask_;
+        const size_t first = std::min(toWrite, capacity_ - offset);
+        std::memcpy(buffer_.get() + offset, data, first * sizeof(T));
+        std::memcpy(buffer_.get(), data + first, (toWrite - first) * sizeof(T));
+
+        head_.store(head + toWrite, std::memory_order_release);
+        return toWrite;
+    }
+
+    /**
+     * @brief Read elements from the buffer (consumer thread only)
+     * @param data Pointer to output buffer
+     * @param count Maximum number of elements to read
+     * @return Number of elements actually read
+     */
+    size_t read(T *data, size_t count)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t available = cachedHead_ - tail;
+        if (available < count)
+        {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            available = cachedHead_ - tail;
+        }
+
+        const size_t toRead = std::min(count, available);
+        if (toRead == 0)
+        {
+            return 0;
+        }
+
+        const size_t offset = tail & mask_;
+        const size_t first = std::min(toRead, capacity_ - offset);
+        std::memcpy(data, buffer_.get() + offset, first * sizeof(T));
+        std::memcpy(data + first, buffer_.get(), (toRead - first) * sizeof(T));
+
+        tail_.store(tail + toRead, std::memory_order_release);
+        return toRead;
+    }
+
+    /**
+     * @brief Drop all readable elements (consumer thread only)
+     */
+    void discard()
+    {
+        cachedHead_ = head_.load(std::memory_order_acquire);
+        tail_.store(cachedHead_, std::memory_order_release);
+    }
+
+    /**
+     * @brief Number of elements available for reading
+     * @note Exact from the consumer thread, a lower bound elsewhere
+     */
+    size_t available() const
+    {
+        // Load tail first so a concurrent write can only make the result smaller than reality
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return head_.load(std::memory_order_acquire) - tail;
+    }
+
+    /**
+     * @brief Number of elements that can be written
+     * @note Exact from the producer thread, a lower bound elsewhere
+     */
+    size_t freeSpace() const
+    {
+        return capacity_ - available();
+    }
+
+    /**
+     * @brief Total capacity in elements (always a power of two)
+     */
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    static size_t roundUpPowerOfTwo(size_t value)
+    {
+        size_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> buffer_;
+
+    // Producer-owned line: write position plus a cached copy of the read position
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+
+    // Consumer-owned line: read position plus a cached copy of the write position
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+};
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+#include "WhisperBridge.h"
+#include "WhisperTranscriber.h"
+
+/**
+ * @brief Multi-session live transcription on one shared Whisper model
+ *
+ * The model is loaded once; every session gets its own whisper_state, so a
+ * session costs its decoder/KV buffers rather than a copy of the weights.
+ * Sessions buffer incoming audio and become ready once a chunk is available;
+ * each chunk ends at a pause in speech, so words are not cut in half at chunk
+ * boundaries. A fixed pool of workers serves ready sessions round-robin, one
+ * chunk at a time, so busy rooms cannot starve quiet ones and total CPU use
+ * stays bounded regardless of session count.
+ */
+class TranscriptionServer
+{
+public:
+    using SessionId = uint64_t;
+    using Result = WhisperTranscriber::Result;
+    using ResultCallback = std::function<void(SessionId, const Result &)>;
+
+    /**
+     * @brief Configuration for the server
+     */
+    struct Config
+    {
+        std::string modelPath;         ///< Path to Whisper model file (loaded once)
+        std::string language = "auto"; ///< Language code for all sessions
+        int workers = 4;               ///< Concurrent whisper_full calls
+        int threadsPerWorker = 2;      ///< Threads used by each whisper_full call
+        float chunkSeconds = 5.0f;     ///< Audio a session buffers before it is scheduled; chunks end at a pause after half of it
+        float maxChunkSeconds = 30.0f; ///< Largest chunk decoded in one job
+        float silenceThreshold = 0.01f; ///< RMS below which a 20 ms frame is a pause (chunk cut points)
+        size_t maxSessions = 64;       ///< openSession() fails beyond this
+        bool useGpu = false;           ///< Use GPU for the shared model
+    };
+
+    /**
+     * @brief Scheduler counters
+     */
+    struct Stats
+    {
+        size_t sessions = 0;          ///< Open sessions
+        size_t readySessions = 0;     ///< Sessions waiting for a worker
+        uint64_t chunksProcessed = 0; ///< Completed jobs
+        double audioSeconds = 0.0;    ///< Audio transcribed
+        double busySeconds = 0.0;     ///< Worker time spent in whisper_full
+    };
+
+    /**
+     * @brief Constructor
+     * @param config Server configuration
+     */
+    explicit TranscriptionServer(const Config &config);
+
+    /**
+     * @brief Destructor; closes all sessions
+     */
+    ~TranscriptionServer();
+
+    /**
+     * @brief Load the shared model and start the worker pool
+     * @return true on success, false on failure
+     */
+    bool initialize();
+
+    /**
+     * @brief Stop the worker pool and release all sessions
+     */
+    void shutdown();
+
+    /**
+     * @brief Open a transcription session
+     * @param callback Called from a worker thread with each result of this session
+     * @return Session id, or 0 on failure
+     */
+    SessionId openSession(ResultCallback callback);
+
+    /**
+     * @brief Append audio to a session
+     * @param id Session id
+     * @param audioData Float audio samples (mono, 16kHz)
+     * @param timestamp Timestamp of the first sample in seconds
+     */
+    void addAudio(SessionId id, const std::vector<float> &audioData, double timestamp);
+
+    /**
+     * @brief Transcribe a session's remaining audio, then release its state
+     * @param id Session id
+     */
+    void closeSession(SessionId id);
+
+    /**
+     * @brief Get scheduler counters
+     */
+    Stats getStats() const;
+
+private:
+    struct Session
+    {
+        SessionId id = 0;
+        whisper_bridge_state *state = nullptr;
+        ResultCallback callback;
+        std::vector<float> buffer; ///< Audio not yet handed to a worker
+        double bufferStart = 0.0;  ///< Timestamp of buffer[0]
+        bool queued = false;       ///< In readyQueue_
+        bool inFlight = false;     ///< A worker is decoding this session's state
+        bool closing = false;      ///< closeSession() called; flush partial chunks
+    };
+
+    Config config_;
+    whisper_bridge_context *model_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable sessionIdle_;
+    std::unordered_map<SessionId, std::shared_ptr<Session>> sessions_;
+    std::deque<std::shared_ptr<Session>> readyQueue_;
+    std::vector<std::thread> workers_;
+    bool stopping_;
+    SessionId nextId_;
+
+    uint64_t chunksProcessed_;
+    double audioSeconds_;
+    double busySeconds_;
+
+    /**
+     * @brief Check whether a session has a chunk to decode (caller holds mutex_)
+     */
+    bool isReady(const Session &session) const;
+
+    /**
+     * @brief Queue a session for a worker if it is ready and idle (caller holds mutex_)
+     */
+    void scheduleIfReady(const std::shared_ptr<Session> &session);
+
+    /**
+     * @brief Choose where a chunk of buffered audio ends
+     *
+     * The middle of the longest pause after chunkSeconds / 2, or the quietest
+     * frame there if nobody paused.
+     * @param audio Buffered audio, at most maxChunkSeconds of it
+     * @return Samples to decode now; the rest stays buffered
+     */
+    size_t findChunkEnd(const std::vector<float> &audio) const;
+
+    /**
+     * @brief Worker thread: decode one chunk per ready session, round-robin
+     */
+    void workerThreadFunction();
+};
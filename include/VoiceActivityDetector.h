@@ -0,0 +1,146 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @brief Streaming frame-based voice activity detector
+ *
+ * Audio of any chunk size is cut into fixed 10/20/30 ms frames. Each frame is
+ * classified from its energy and zero-crossing rate (vectorized) against an
+ * adaptive noise floor. Speech starts after a few consecutive speech frames and
+ * is emitted together with a short pre-roll; it ends only after a hangover of
+ * non-speech frames, so brief pauses do not split an utterance.
+ */
+class VoiceActivityDetector
+{
+public:
+    /**
+     * @brief Configuration for the detector
+     */
+    struct Config
+    {
+        unsigned int sampleRate = 16000; ///< Input sample rate
+        unsigned int frameMs = 20;       ///< Analysis frame length: 10, 20 or 30 ms
+        unsigned int onsetMs = 60;       ///< Consecutive speech needed to start an utterance
+        unsigned int hangoverMs = 400;   ///< Non-speech needed to end an utterance
+        unsigned int preRollMs = 200;    ///< Audio before the onset emitted with the utterance
+        float minEnergy = 1e-4f;         ///< Absolute energy floor for speech (mean square)
+        float noiseRatio = 4.0f;         ///< Speech energy must exceed the noise floor by this factor (~6 dB)
+        float maxZeroCrossingRate = 0.35f; ///< Weak frames crossing zero more often than this are treated as noise
+        float noiseAdaptRate = 0.05f;    ///< Noise floor tracking rate during non-speech
+    };
+
+    /**
+     * @brief Called with VAD-positive audio, in order
+     * @param samples Speech samples (pre-roll, speech and hangover)
+     * @param count Number of samples
+     * @param timestamp Timestamp of samples[0] in seconds
+     */
+    using SpeechCallback = std::function<void(const float *samples, size_t count, double timestamp)>;
+
+    /**
+     * @brief Called when an utterance ends
+     * @param timestamp Timestamp of the end of the utterance in seconds
+     */
+    using EndCallback = std::function<void(double timestamp)>;
+
+    /**
+     * @brief Constructor
+     * @param config Detector configuration
+     */
+    explicit VoiceActivityDetector(const Config &config);
+
+    /**
+     * @brief Set the output callbacks
+     */
+    void setCallbacks(SpeechCallback onSpeech, EndCallback onSpeechEnd);
+
+    /**
+     * @brief Feed audio
+     * @param samples Mono samples at Config::sampleRate
+     * @param count Number of samples
+     * @param timestamp Timestamp of samples[0]; only used to anchor the first call after reset()
+     */
+    void process(const float *samples, size_t count, double timestamp);
+
+    /**
+     * @brief End an active utterance immediately (e.g. at end of stream)
+     */
+    void flush();
+
+    /**
+     * @brief Forget all state, including the noise floor
+     */
+    void reset();
+
+    /**
+     * @brief Check whether an utterance is in progress
+     */
+    bool isSpeaking() const;
+
+    /**
+     * @brief Current noise floor estimate (mean square energy)
+     */
+    float getNoiseFloor() const;
+
+    /**
+     * @brief Mean square energy and zero-crossing rate of a frame
+     * @param samples Frame samples
+     * @param count Number of samples
+     * @param energy Mean of the squared samples
+     * @param zeroCrossingRate Fraction of adjacent sample pairs that change sign
+     */
+    static void frameFeatures(const float *samples, size_t count, float &energy, float &zeroCrossingRate);
+
+    /**
+     * @brief Choose a frame to cut audio at
+     *
+     * The middle of the longest run of non-speech frames in [begin, end), or
+     * the quietest frame there if every frame is speech.
+     * @param energy Mean square energy per frame
+     * @param speech Speech decision per frame (non-zero = speech)
+     * @param begin First frame the cut may fall on
+     * @param end One past the last frame the cut may fall on
+     * @return Frame index in [begin, end); begin if the range is empty
+     */
+    static size_t findPause(const std::vector<float> &energy, const std::vector<uint8_t> &speech, size_t begin, size_t end);
+
+private:
+    Config config_;
+    SpeechCallback onSpeech_;
+    EndCallback onSpeechEnd_;
+
+    size_t frameSamples_;
+    unsigned int onsetFrames_;
+    unsigned int hangoverFrames_;
+    size_t preRollFrames_;
+
+    std::vector<float> frame_; ///< Partial frame being accumulated
+    size_t frameFill_;
+    uint64_t framesSeen_;
+    double originTime_; ///< Timestamp of the first sample since reset()
+    bool anchored_;
+
+    float noiseFloor_;
+    bool speaking_;
+    unsigned int speechRun_;      ///< Consecutive speech frames while silent
+    unsigned int hangoverLeft_;   ///< Non-speech frames left before the utterance ends
+
+    // Ring of the most recent frames, replayed as pre-roll at onset
+    std::vector<float> preRoll_;
+    size_t preRollHead_;
+    size_t preRollCount_;
+
+    /**
+     * @brief Classify a complete frame and advance the state machine
+     */
+    void processFrame(const float *frame);
+
+    /**
+     * @brief Timestamp of the start of a frame
+     */
+    double frameTime(uint64_t frameIndex) const;
+};
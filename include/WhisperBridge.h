@@ -9,31 +9,113 @@ extern "C" {
 
 // Forward declare opaque handle types (no ggml exposure)
 typedef struct whisper_bridge_context whisper_bridge_context;
+typedef struct whisper_bridge_state whisper_bridge_state;
+
+// Decode profiles
+typedef enum {
+    WHISPER_BRIDGE_PROFILE_DEFAULT = 0,     // Full 30 s encoder window, whisper's default decoding
+    WHISPER_BRIDGE_PROFILE_LOW_LATENCY = 1, // Encoder context scaled to the chunk, single segment,
+                                            // no temperature fallback, tokens capped by duration
+} whisper_bridge_profile;
 
 // Configuration structure (plain C types only)
 typedef struct {
     const char* model_path;
-    const char* language;
-    int threads;
-    int max_len_ms;
-    float vad_threshold;
+    const char* language;           // Default decode language (copied)
+    int threads;                    // Default decode threads
+    int max_len_ms;                 // Informational only: every call decodes all of its audio (whisper_full windows long input)
+    float vad_threshold;            // Speech probability threshold for whisper's built-in VAD (0 = 0.5)
     bool use_gpu;
+    whisper_bridge_profile profile;
+    bool prefault;                  // Start reading the model file into the page cache (madvise WILLNEED) before loading
 } whisper_bridge_params;
 
+typedef enum {
+    WHISPER_BRIDGE_SAMPLING_GREEDY = 0,
+    WHISPER_BRIDGE_SAMPLING_BEAM_SEARCH = 1,
+} whisper_bridge_sampling;
+
+// Per-call decoding parameters; strings are copied by the bridge
+typedef struct {
+    whisper_bridge_sampling strategy;
+    int beam_size;           // Beam search width
+    int best_of;             // Greedy candidates sampled at non-zero temperature
+    float temperature;       // Initial sampling temperature
+    float temperature_inc;   // Fallback step when a decode fails the thresholds below (0 = no fallback)
+    float entropy_thold;     // Fall back when token entropy is above this (repetition)
+    float logprob_thold;     // Fall back when the average log probability is below this
+    float no_speech_thold;   // Treat a segment as silence when no-speech probability is above this
+    int max_tokens;          // Tokens per segment (0 = no limit)
+    bool translate;          // Translate to English
+    bool suppress_nst;       // Suppress non-speech tokens ([music], (laughs), ...)
+    bool vad;                // Run whisper's built-in VAD before decoding (needs vad_model_path)
+    const char* vad_model_path; // Silero VAD model for the built-in VAD
+    float vad_threshold;     // Built-in VAD speech probability threshold
+    int threads;             // Decode threads (0 = context default)
+    const char* language;    // Language code (NULL = context default)
+    whisper_bridge_profile profile; // Decode profile of this call; a context's own parameters follow whisper_bridge_set_profile
+} whisper_bridge_decode_params;
+
+// Decoded text token; strings point into the owning result's arena
+typedef struct {
+    int32_t id;
+    const char* text;
+    float p;              // Token probability
+    float plog;           // Log probability
+    int64_t t0_ms;        // Token timestamps (estimated by whisper's token timestamp pass)
+    int64_t t1_ms;
+} whisper_bridge_token;
+
+// Decoded segment: a run of tokens in the result's token array
+typedef struct {
+    const char* text;
+    int64_t start_time_ms;
+    int64_t end_time_ms;
+    float confidence;     // Mean probability of the segment's tokens
+    float no_speech_prob;
+    int first_token;      // Index into tokens
+    int n_tokens;
+} whisper_bridge_segment;
+
 // Result structure (plain C types only)
 typedef struct {
-    char* text;           // Allocated string - caller must free
-    float confidence;
+    char* text;           // Allocated string (or arena text) - released by whisper_bridge_free_result
+    float confidence;     // Mean token probability
     int64_t start_time_ms;
     int64_t end_time_ms;
     bool success;
     char* error_msg;      // Allocated string - caller must free on error
+    bool is_partial;      // Streaming: hypothesis for the current window, replaced by later results
+    const char* language; // Language decoded (detected when "auto"); static string, not freed
+    whisper_bridge_segment* segments; // Transcription calls: every segment, in order (NULL otherwise)
+    int n_segments;
+    whisper_bridge_token* tokens;     // Text tokens of all segments (special tokens are left out)
+    int n_tokens;
+    void* arena;          // Single allocation behind text, segments and tokens
 } whisper_bridge_result;
 
+// Streaming window configuration
+typedef struct {
+    int step_ms;           // Decode the window after this much new audio (partial results)
+    int length_ms;         // Window length; a full window is committed as a final result
+    int keep_ms;           // Audio carried over into the next window for boundary words
+    int max_prompt_tokens; // Committed tokens fed back as the decoder prompt
+} whisper_bridge_stream_params;
+
 // API Functions
+// Contexts opened with the same model_path/use_gpu share one copy of the weights;
+// the model is unloaded when the last of them is freed.
 whisper_bridge_context* whisper_bridge_init(whisper_bridge_params params);
 void whisper_bridge_free(whisper_bridge_context* ctx);
 
+// Number of distinct models currently loaded
+int whisper_bridge_loaded_models(void);
+
+// Decode audio_ms of silence (at most one token) and discard the result, so the first real call
+// does not pay for compute buffer allocation, backend initialization and cold weight pages.
+// state NULL = the context's own decoding state (created here if needed).
+bool whisper_bridge_warmup(whisper_bridge_context* ctx, whisper_bridge_state* state, int audio_ms);
+
 whisper_bridge_result whisper_bridge_transcribe_audio(
     whisper_bridge_context* ctx,
     const float* audio_data,
@@ -43,15 +125,103 @@ whisper_bridge_result whisper_bridge_transcribe_audio(
 
 void whisper_bridge_free_result(whisper_bridge_result* result);
 
+// Decode parameters: whisper's defaults, or the ones a context currently uses.
+// Changing them never reloads the model or reallocates decoding state.
+whisper_bridge_decode_params whisper_bridge_decode_default_params(void);
+whisper_bridge_decode_params whisper_bridge_get_decode_params(const whisper_bridge_context* ctx);
+
+// Set the parameters used by every later call on this context that does not pass its own
+// (the context keeps its profile; change it with whisper_bridge_set_profile)
+void whisper_bridge_set_decode_params(whisper_bridge_context* ctx, const whisper_bridge_decode_params* params);
+
+// Switch the decode profile of a live context (takes effect with the next decode). Calls that pass
+// their own parameters use the profile in them instead, so they never race with a switch.
+void whisper_bridge_set_profile(whisper_bridge_context* ctx, whisper_bridge_profile profile);
+whisper_bridge_profile whisper_bridge_get_profile(const whisper_bridge_context* ctx);
+
+// One call with explicit parameters (NULL = the context's)
+whisper_bridge_result whisper_bridge_transcribe_audio_with_params(
+    whisper_bridge_context* ctx,
+    const float* audio_data,
+    int audio_len,
+    const whisper_bridge_decode_params* params
+);
+
+// Spoken language of up to the first 30 s of audio (one encoder pass, no decoding).
+// Returns a static language code, or NULL on failure; *probability (optional) receives its probability.
+// state NULL = the context's own decoding state. English-only models always report "en".
+const char* whisper_bridge_detect_language(
+    whisper_bridge_context* ctx,
+    whisper_bridge_state* state,
+    const float* audio_data,
+    int audio_len,
+    int threads,
+    float* probability
+);
+
+// Per-worker decoding state sharing the context's model weights.
+// Each state may be used by one thread at a time; different states may decode concurrently.
+whisper_bridge_state* whisper_bridge_state_init(whisper_bridge_context* ctx);
+void whisper_bridge_state_free(whisper_bridge_state* state);
+
+whisper_bridge_result whisper_bridge_transcribe_with_state(
+    whisper_bridge_context* ctx,
+    whisper_bridge_state* state,
+    const float* audio_data,
+    int audio_len,
+    int threads
+);
+
+whisper_bridge_result whisper_bridge_transcribe_with_state_params(
+    whisper_bridge_context* ctx,
+    whisper_bridge_state* state,
+    const float* audio_data,
+    int audio_len,
+    const whisper_bridge_decode_params* params
+);
+
+// Incremental results for whisper_bridge_transcribe_audio: each segment is reported as soon as
+// whisper finalizes it, laid out like a transcription result holding that one segment and its
+// text tokens, with its own start/end times (ms, relative to the audio passed in).
+// The result passed to the callback is freed by the bridge after the call returns.
+// Pass NULL to unregister.
+typedef void (*whisper_bridge_segment_callback)(const whisper_bridge_result* segment, void* user_data);
+typedef void (*whisper_bridge_progress_callback)(int progress_percent, void* user_data);
+
+void whisper_bridge_set_segment_callback(
+    whisper_bridge_context* ctx,
+    whisper_bridge_segment_callback callback,
+    void* user_data
+);
+
+void whisper_bridge_set_progress_callback(
+    whisper_bridge_context* ctx,
+    whisper_bridge_progress_callback callback,
+    void* user_data
+);
+
 // Real-time processing
+// Audio is decoded in a sliding window: a partial result every step_ms, a final one
+// whenever the window fills. Each window is prompted with the previously committed
+// tokens, and words repeated in the keep_ms overlap are removed by token alignment.
+// Stream timestamps are absolute (from the timestamps passed to add_audio).
 typedef void (*whisper_bridge_callback)(const whisper_bridge_result* result, void* user_data);
 
+whisper_bridge_stream_params whisper_bridge_stream_default_params(void);
+
 bool whisper_bridge_start_stream(
     whisper_bridge_context* ctx, 
     whisper_bridge_callback callback,
     void* user_data
 );
 
+bool whisper_bridge_start_stream_with_params(
+    whisper_bridge_context* ctx,
+    whisper_bridge_stream_params params,
+    whisper_bridge_callback callback,
+    void* user_data
+);
+
 void whisper_bridge_add_audio(
     whisper_bridge_context* ctx,
     const float* audio_data,
@@ -59,6 +229,10 @@ void whisper_bridge_add_audio(
     double timestamp
 );
 
+// Commit the current window as a final result and start a new one (e.g. at the end of an utterance).
+// The prompt carries over; the next add_audio call re-anchors the stream timestamp.
+void whisper_bridge_flush_stream(whisper_bridge_context* ctx);
+
 void whisper_bridge_stop_stream(whisper_bridge_context* ctx);
 
 #ifdef __cplusplus
@@ -1,16 +1,20 @@
 #pragma once
 
 #include <vector>
+#include <deque>
 #include <string>
 #include <memory>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
 #include <atomic>
+#include <chrono>
 #include <functional>
 
 #include "WhisperBridge.h"
+#include "VoiceActivityDetector.h"
+#include "AudioChunkPool.h"
+#include "RtfGovernor.h"
 
 /**
  * @brief Whisper-based speech transcription class
@@ -21,6 +25,20 @@
 class WhisperTranscriber
 {
 public:
+    /**
+     * @brief Reaction of the real-time queue to a growing backlog
+     *
+     * The policy kicks in when the queue holds more than half of maxQueueMs
+     * and is lifted once it drains below a quarter. At maxQueueMs the oldest
+     * audio is dropped whatever the policy.
+     */
+    enum class OverloadPolicy
+    {
+        DropOldest,    ///< Nothing beyond dropping at the bound
+        Coalesce,      ///< Decode the backlog in maxSegmentLength windows: fewer encoder passes per second of audio
+        SwitchProfile, ///< Decode with the low-latency profile until the backlog drains
+    };
+
     /**
      * @brief Configuration for Whisper transcriber
      */
@@ -29,11 +47,83 @@ public:
         std::string modelPath;          ///< Path to Whisper model file
         int threads = 4;                ///< Number of threads for inference
         std::string language = "auto";  ///< Language code ("en", "auto", etc.)
+        bool lockLanguage = true;       ///< With "auto": detect once per real-time session, then decode with that language
+        int languageDetectSeconds = 3;  ///< Audio analyzed before the language is pinned
+        float languageLockConfidence = 0.7f; ///< Probability needed to pin; below it detection retries on more audio (up to 30 s)
+        int languageRecheckSeconds = 0; ///< Re-run detection after this much audio (0 = never)
         bool translate = false;         ///< Translate to English if source is not English
         float silenceThreshold = 0.01f; ///< Silence detection threshold
         int maxSegmentLength = 30;      ///< Maximum segment length in seconds
-        bool enableVAD = true;          ///< Enable Voice Activity
+        bool enableVAD = true;          ///< Only transcribe VAD-positive audio in real-time mode
+        unsigned int vadFrameMs = 20;   ///< VAD frame length: 10, 20 or 30 ms
+        unsigned int vadHangoverMs = 400; ///< Silence that ends an utterance
+        unsigned int vadPreRollMs = 200;  ///< Audio kept before speech onset
+        bool streaming = false;         ///< Real-time mode: sliding-window decode with partial results
+        int streamStepMs = 500;         ///< Streaming: partial result interval
+        int streamLengthMs = 5000;      ///< Streaming: window committed as a final result
+        int streamKeepMs = 200;         ///< Streaming: overlap between consecutive windows
+        bool segmentCallbacks = true;   ///< Real-time mode: deliver each segment as soon as Whisper decodes it
+        bool lowLatency = false;        ///< Encoder context scaled to the chunk length, single segment, no fallback
+        bool beamSearch = false;        ///< Beam search instead of greedy decoding
+        int beamSize = 5;               ///< Beam width when beamSearch is set
+        int bestOf = 5;                 ///< Greedy candidates sampled at non-zero temperature
+        float temperatureIncrement = 0.2f; ///< Temperature fallback step (0 = no fallback)
+        float entropyThreshold = 2.4f;  ///< Fall back when token entropy is above this
+        float logprobThreshold = -1.0f; ///< Fall back when average log probability is below this
+        float noSpeechThreshold = 0.6f; ///< Treat segments above this no-speech probability as silence
+        int maxTokensPerSegment = 0;    ///< Token cap per segment (0 = no limit)
+        std::string whisperVadModel;    ///< Silero model for whisper's built-in VAD (empty = off)
+        float whisperVadThreshold = 0.5f; ///< Built-in VAD speech probability threshold
         bool suppressNonSpeech = true;  ///< Suppress non-speech tokens
+        int offlineWorkers = 0;         ///< Offline mode: whisper states decoding in parallel (0 = cores / offlineThreadsPerWorker)
+        int offlineThreadsPerWorker = 2; ///< Offline mode: threads used by each worker's whisper_full call
+        int maxQueueMs = 30000;         ///< Real-time queue bound; older audio is dropped beyond it (0 = unbounded)
+        OverloadPolicy overloadPolicy = OverloadPolicy::DropOldest; ///< Reaction to a backlog above half the bound
+        bool rtfGovernor = false;       ///< Degrade decoding step by step while the real-time factor is above 1.0
+        std::string fallbackModelPath;  ///< Smaller model the governor switches to last (not used when streaming)
+        std::string partialModelPath;   ///< Cascade: small model streaming live partials; modelPath re-decodes each utterance (needs enableVAD)
+        int finalThreads = 0;           ///< Cascade: threads for final decodes (0 = half of threads)
+        int maxPendingFinals = 8;       ///< Cascade: queued utterances before the oldest is finalized with its partial text
+        bool refineLowConfidence = false; ///< Re-decode low-confidence final segments with beam search in the background
+        float refineConfidenceThreshold = 0.6f; ///< Refine segments whose mean token probability is below this
+        float refineLogprobThreshold = -1.0f;   ///< ... or whose mean token log probability is below this
+        int refineBeamSize = 5;         ///< Beam width of the second pass
+        int refineMaxPending = 16;      ///< Queued segments beyond which new candidates are left as they are
+        bool prefaultModel = true;      ///< Start reading model files into the page cache before loading them
+        bool warmup = true;             ///< Run a silent 1 s decode on each live model during initialize()
+    };
+
+    /**
+     * @brief Overload counters for real-time processing
+     */
+    struct OverloadStats
+    {
+        uint64_t droppedChunks = 0;     ///< Queued chunks dropped at the bound
+        uint64_t droppedSamples = 0;    ///< Audio dropped at the bound (16kHz samples)
+        uint64_t overloadEvents = 0;    ///< Times the backlog crossed half the bound
+        uint64_t coalescedDecodes = 0;  ///< Decodes run on a coalesced window
+        uint64_t profileSwitches = 0;   ///< Switches to the low-latency profile (policy or governor)
+        uint64_t beamReductions = 0;    ///< Governor switches to plain greedy decoding
+        uint64_t modelSwitches = 0;     ///< Governor switches to the fallback model
+        uint64_t governorStepsDown = 0; ///< Governor level increases
+        uint64_t governorStepsUp = 0;   ///< Governor level decreases
+        uint64_t finalsFromPartials = 0; ///< Cascade: utterances finalized with partial-model text because finals fell behind
+        size_t peakQueuedSamples = 0;   ///< Largest backlog seen (16kHz samples)
+        double rtf = 0.0;               ///< Smoothed real-time factor of recent decodes
+        int governorLevel = 0;          ///< Degradation steps currently applied
+    };
+
+    /**
+     * @brief Decoded text token
+     */
+    struct Token
+    {
+        int id;            ///< Whisper token id
+        std::string text;  ///< Token text (usually with its leading space)
+        float probability; ///< Token probability (0.0 - 1.0)
+        float logProbability; ///< Token log probability
+        double startTime;  ///< Estimated start in seconds
+        double endTime;    ///< Estimated end in seconds
     };
 
     /**
@@ -44,8 +134,45 @@ public:
         std::string text;     ///< Transcribed text
         double startTime;     ///< Start time in seconds
         double endTime;       ///< End time in seconds
-        float confidence;     ///< Confidence score (0.0 - 1.0)
-        std::string language; ///< Detected language
+        float confidence;     ///< Mean token probability (0.0 - 1.0)
+        std::string language; ///< Language the audio was decoded as (detected or pinned when "auto")
+        bool partial = false; ///< Streaming hypothesis; replaced by the next result
+        uint64_t utterance = 0; ///< Cascade: utterance the partial or final belongs to
+        std::vector<Token> tokens; ///< Tokens of the segment; empty for streaming windows
+        uint64_t segmentId = 0; ///< Final results: index in the session transcript (see getTranscript())
+    };
+
+    /**
+     * @brief A final segment replaced by the beam-search second pass
+     */
+    struct Correction
+    {
+        uint64_t segmentId;       ///< Transcript entry that changed
+        std::string previousText; ///< Text as first emitted
+        Result result;            ///< Replacement (same segmentId and time span)
+    };
+
+    /**
+     * @brief Second-pass counters
+     */
+    struct RefinementStats
+    {
+        uint64_t finalSegments = 0; ///< Final segments emitted
+        uint64_t candidates = 0;    ///< Segments below the confidence thresholds
+        uint64_t skipped = 0;       ///< Candidates dropped because the queue was full
+        uint64_t redecoded = 0;     ///< Segments decoded again with beam search
+        uint64_t corrected = 0;     ///< Re-decodes that replaced the text
+        double redecodedSeconds = 0.0; ///< Audio decoded by the second pass
+    };
+
+    /**
+     * @brief Where startup time went
+     */
+    struct StartupTimeline
+    {
+        double loadMs = 0.0;         ///< initialize(): loading every model
+        double warmupMs = 0.0;       ///< initialize(): warm-up decodes
+        double firstResultMs = -1.0; ///< startRealTimeProcessing() to the first delivered result (-1 = none yet)
     };
 
     /**
@@ -72,6 +199,28 @@ public:
      */
     std::vector<Result> transcribe(const std::vector<float> &audioData);
 
+    /**
+     * @brief Transcribe audio data in place
+     * @param samples Float audio samples (mono, 16kHz)
+     * @param count Number of samples
+     * @return Transcription results
+     */
+    std::vector<Result> transcribe(const float *samples, size_t count);
+
+    /**
+     * @brief Transcribe a long recording in parallel
+     *
+     * Splits the audio at silences into segments of at most maxSegmentLength
+     * seconds and decodes them on a work-stealing pool of whisper states that
+     * share this transcriber's model. Results are returned in timestamp order.
+     *
+     * @param audioData Float audio samples (mono, 16kHz)
+     * @param progress Optional callback with (segments done, segments total); called from worker threads
+     * @return Transcription results, one per non-silent segment
+     */
+    std::vector<Result> transcribeOffline(const std::vector<float> &audioData,
+                                          std::function<void(size_t, size_t)> progress = nullptr);
+
     /**
      * @brief Add audio data to the transcription queue (for real-time processing)
      * @param audioData Float audio samples (mono, 16kHz)
@@ -79,6 +228,38 @@ public:
      */
     void addAudioData(const std::vector<float> &audioData, double timestamp);
 
+    /**
+     * @brief Queue a pooled audio chunk without copying it (for real-time processing)
+     * @param chunk Float audio samples (mono, 16kHz) with the timestamp of the first sample
+     */
+    void addAudioData(const AudioChunkHandle &chunk);
+
+    /**
+     * @brief Receive corrections from the beam-search second pass (set before starting)
+     * @param callback Called on the refinement thread, never concurrently with the result callback
+     */
+    void setCorrectionCallback(std::function<void(const Correction &)> callback);
+
+    /**
+     * @brief Get the final segments of the current session, with corrections applied
+     */
+    std::vector<Result> getTranscript() const;
+
+    /**
+     * @brief Get the session transcript as text, with corrections applied
+     */
+    std::string getTranscriptText() const;
+
+    /**
+     * @brief Get the second-pass counters of the current session
+     */
+    RefinementStats getRefinementStats() const;
+
+    /**
+     * @brief Get the load, warm-up and first-result latencies
+     */
+    StartupTimeline getStartupTimeline() const;
+
     /**
      * @brief Start real-time transcription processing
      * @param callback Function to call with transcription results
@@ -90,6 +271,17 @@ public:
      */
     void stopRealTimeProcessing();
 
+    /**
+     * @brief Get the amount of queued or buffered audio not yet transcribed
+     * @return Pending samples (16kHz); used by offline sources for flow control
+     */
+    size_t getPendingSamples() const;
+
+    /**
+     * @brief Get the overload counters and the current real-time factor
+     */
+    OverloadStats getOverloadStats() const;
+
     /**
      * @brief Check if the transcriber is initialized
      * @return true if initialized, false otherwise
@@ -103,47 +295,268 @@ public:
     static std::vector<std::string> getSupportedLanguages();
 
     /**
-     * @brief Set transcription language
+     * @brief Get the language pinned for the current session
+     * @return Language code, or empty while it is still being detected (or not locked)
+     */
+    std::string getSessionLanguage() const;
+
+    /**
+     * @brief Set transcription language (takes effect with the next decode)
      * @param language Language code ("en", "es", "fr", etc.) or "auto"
      */
     void setLanguage(const std::string &language);
 
 private:
+    /**
+     * @brief Rungs of the governor's degradation ladder, cheapest loss first
+     */
+    enum class GovernorStep
+    {
+        ReduceBeam,      ///< Greedy decoding without temperature fallback
+        TruncateContext, ///< Low-latency profile (audio_ctx scaled to the chunk)
+        SmallerModel,    ///< Decode with fallbackModelPath
+    };
+
+    /**
+     * @brief Cascade: VAD-closed utterance waiting for the final model
+     */
+    struct FinalJob
+    {
+        std::vector<float> audio;
+        double startTime = 0.0;
+        uint64_t utterance = 0;
+        std::string draft; ///< Committed partial-model text, used if the final decode is skipped
+    };
+
     Config config_;
     whisper_bridge_context *whisperContext_;
+    whisper_bridge_context *fallbackContext_; ///< Loaded when fallbackModelPath is set
+    whisper_bridge_context *activeContext_;   ///< Context buffered decodes run on
     bool initialized_;
 
     // Real-time processing
-    std::queue<std::pair<std::vector<float>, double>> audioQueue_;
+    AudioChunkQueue audioQueue_;
+    std::unique_ptr<AudioChunkPool> chunkPool_; ///< Holds audio passed in as vectors
     std::mutex queueMutex_;
     std::condition_variable queueCondition_;
     std::thread processingThread_;
     std::atomic<bool> shouldStop_;
     std::function<void(const Result &)> resultCallback_;
+    std::atomic<size_t> pendingSamples_; ///< Samples added but not yet transcribed
+    std::unique_ptr<VoiceActivityDetector> vad_; ///< Gates audio into the buffer when enableVAD is set
+
+    // Overload handling
+    size_t queuedSamples_;            ///< Samples in audioQueue_ (guarded by queueMutex_)
+    bool queueGap_;                   ///< Audio was dropped since the last dequeue (guarded by queueMutex_)
+    std::atomic<bool> overloaded_;    ///< Backlog above half the bound, not yet drained below a quarter
+    bool policyActive_;               ///< The overload policy is currently applied
+    bool coalescing_;                 ///< Buffer grows to maxSegmentLength before decoding
+    std::unique_ptr<RtfGovernor> governor_;
+    std::vector<GovernorStep> governorLadder_;
+    int governorLevel_;
+    double streamAudioSeconds_;       ///< Streaming audio since the last governor update
+    double streamDecodeSeconds_;      ///< Time spent in whisper_bridge_add_audio for it
+    mutable std::mutex statsMutex_;
+    OverloadStats stats_;
+
+    // Two-model cascade
+    whisper_bridge_context *partialContext_; ///< Loaded when partialModelPath is set
+    whisper_bridge_context *streamContext_;  ///< Context the real-time stream runs on
+    bool cascade_;                           ///< Partials from partialContext_, finals from whisperContext_
+    uint64_t utteranceId_;                   ///< Utterance currently being streamed
+    std::string draft_;                      ///< Committed partial text of the current utterance
+    std::deque<FinalJob> finalJobs_;
+    std::vector<std::vector<float>> spareBuffers_; ///< Utterance buffers returned by the final thread
+    std::mutex finalMutex_;
+    std::condition_variable finalCondition_;
+    std::thread finalThread_;
+    bool finalStop_;
+    std::mutex callbackMutex_; ///< Results arrive from the processing and final threads
+    std::atomic<bool> finalParamsDirty_; ///< Cascade: the final thread must reload its decode parameters
+
+    // Startup timeline
+    double loadMs_;
+    double warmupMs_;
+    std::chrono::steady_clock::time_point sessionStart_;
+    std::atomic<double> firstResultMs_; ///< Set once per session by deliverResult()
+
+    // Session transcript and beam-search second pass
+    struct RefineJob
+    {
+        uint64_t segmentId = 0;
+        AudioChunkHandle audio; ///< Segment audio with a little context on both sides
+    };
+
+    std::vector<Result> transcript_;   ///< Final segments by segmentId (without tokens)
+    RefinementStats refineStats_;
+    mutable std::mutex transcriptMutex_; ///< Guards transcript_ and refineStats_
+    std::function<void(const Correction &)> correctionCallback_;
+    std::deque<RefineJob> refineJobs_;
+    std::mutex refineMutex_;
+    std::condition_variable refineCondition_;
+    std::thread refineThread_;
+    bool refineStop_;
+    whisper_bridge_state *refineState_;       ///< Second-pass decoding state on the main model
+    whisper_bridge_decode_params refineParams_; ///< Beam-search parameters snapshot for the session
+    whisper_bridge_state *languageState_;     ///< Language detection state on the main model (cascade), kept for the session
+
+    // Session language lock
+    std::vector<float> languageProbe_; ///< Audio collected for the next detection
+    size_t languageProbeTarget_;       ///< Probe length that triggers a detection attempt
+    bool languageProbing_;             ///< Collecting audio for a detection
+    bool languageDetectionFailed_;     ///< The model could not detect; stay on "auto"
+    size_t samplesSincePin_;           ///< Audio decoded with the pinned language (for re-checks)
+    std::string pinnedLanguage_;       ///< Guarded by languageMutex_
+    std::string pendingLanguage_;      ///< setLanguage() during a session; guarded by languageMutex_
+    std::atomic<bool> languageDirty_;  ///< The processing thread must apply pendingLanguage_
+    mutable std::mutex languageMutex_;
 
     // Audio buffering for real-time processing
     std::vector<float> audioBuffer_;
     double bufferStartTime_;
     static constexpr size_t BUFFER_SIZE_SECONDS = 10;     ///< Buffer size in seconds
     static constexpr size_t MIN_PROCESS_SIZE_SECONDS = 2; ///< Minimum audio length to process
+    double segmentOffset_;    ///< Start time of the buffer whose segments are being reported
+    size_t segmentsReported_; ///< Segments delivered by onSegment() for the current buffer
 
     /**
      * @brief Real-time processing thread function
      */
     void processingThreadFunction();
 
+    /**
+     * @brief Route one queued chunk into the buffer (through the VAD when enabled)
+     * @param chunk Audio samples (mono, 16kHz) and the timestamp of the first sample
+     */
+    void consumeAudio(const AudioChunk &chunk);
+
+    /**
+     * @brief Append samples to the buffer, transcribing it when full
+     */
+    void appendToBuffer(const float *samples, size_t count, double timestamp);
+
+    /**
+     * @brief Cascade: hand the buffered utterance to the final thread
+     */
+    void submitFinal();
+
+    /**
+     * @brief Cascade: decode queued utterances with the final model at reduced priority
+     */
+    void finalThreadFunction();
+
+    /**
+     * @brief Call resultCallback_, one result at a time
+     */
+    void deliverResult(const Result &result);
+
+    /**
+     * @brief Record a final segment in the transcript, deliver it and queue it for refinement if needed
+     * @param result Final result with absolute timestamps
+     * @param audio Audio the segment was decoded from (nullptr = not refinable)
+     * @param count Samples in audio
+     * @param audioStart Timestamp of audio[0]
+     */
+    void emitFinal(Result result, const float *audio, size_t count, double audioStart);
+
+    /**
+     * @brief Re-decode queued low-confidence segments with beam search at reduced priority
+     */
+    void refineThreadFunction();
+
+    /**
+     * @brief Feed the bridge stream, timing the decodes it triggers
+     */
+    void addStreamAudio(const float *samples, size_t count, double timestamp);
+
+    /**
+     * @brief Subtract transcribed or dropped samples from pendingSamples_, stopping at zero
+     *
+     * Called from the processing, final and refine threads; the clamp is a single atomic update.
+     */
+    void releasePendingSamples(size_t count);
+
+    /**
+     * @brief Drop the oldest queued audio beyond maxQueueMs and update the overload flag
+     *
+     * Called with queueMutex_ held after a push.
+     */
+    void enforceQueueBound();
+
+    /**
+     * @brief Apply or lift the overload policy to match overloaded_ (processing thread)
+     */
+    void updateOverloadResponse();
+
+    /**
+     * @brief Close the utterance or window that dropped audio cut through
+     */
+    void handleQueueGap();
+
+    /**
+     * @brief Feed one decode to the governor and apply its level
+     */
+    void recordDecode(double audioSeconds, double decodeSeconds);
+
+    /**
+     * @brief Switch decoding to the given governor level
+     */
+    void applyGovernorLevel(int level);
+
+    /**
+     * @brief Check whether a ladder step is applied at the current governor level
+     */
+    bool governorStepActive(GovernorStep step) const;
+
+    /**
+     * @brief Set the bridge profile required by the config, policy and governor
+     */
+    void updateProfile();
+
+    /**
+     * @brief Samples at which the buffer is transcribed even without a pause
+     */
+    size_t bufferLimit() const;
+
+    /**
+     * @brief Transcribe on a specific bridge context
+     */
+    std::vector<Result> transcribeWithContext(whisper_bridge_context *context, const float *samples, size_t count);
+
+    /**
+     * @brief Bridge stream callback; forwards results to resultCallback_
+     */
+    static void onStreamResult(const whisper_bridge_result *result, void *userData);
+
+    /**
+     * @brief Bridge segment callback; forwards each decoded segment to resultCallback_
+     */
+    static void onSegment(const whisper_bridge_result *segment, void *userData);
+
     /**
      * @brief Process accumulated audio buffer
      * @return true if processing was successful
      */
     bool processBuffer();
 
+    /**
+     * @brief Split audio into segments at silences for offline transcription
+     *
+     * Speech and silence are decided by a VoiceActivityDetector configured like
+     * the live one; cuts fall in the middle of the longest pause.
+     * @param audioData Audio samples (mono, 16kHz)
+     * @param maxSamples Maximum segment length in samples
+     * @return [begin, end) sample ranges in order; segments without speech are omitted
+     */
+    std::vector<std::pair<size_t, size_t>> splitAtSilence(const std::vector<float> &audioData, size_t maxSamples) const;
+
     /**
      * @brief Detect if audio contains speech
-     * @param audioData Audio samples to analyze
+     * @param samples Audio samples to analyze
+     * @param count Number of samples
      * @return true if speech is detected
      */
-    bool detectSpeech(const std::vector<float> &audioData) const;
+    bool detectSpeech(const float *samples, size_t count) const;
 
     /**
      * @brief Convert whisper results to our Result structure
@@ -152,6 +565,49 @@ private:
      */
     std::vector<Result> extractResults(const whisper_bridge_result &result) const;
 
+    /**
+     * @brief Move a result decoded from a buffer to absolute time
+     * @param result Result with segment and token times relative to the buffer
+     * @param offset Timestamp of the buffer's first sample in seconds
+     */
+    static void offsetTimes(Result &result, double offset);
+
+    /**
+     * @brief Push the decoding fields of config_ to the bridge
+     */
+    void applyDecodeParams();
+
+    /**
+     * @brief Apply a language set by setLanguage() during a session (processing thread)
+     */
+    void applyPendingLanguage();
+
+    /**
+     * @brief VAD fields of config_ as detector configuration
+     */
+    VoiceActivityDetector::Config buildVadConfig() const;
+
+    /**
+     * @brief Decoding fields of config_ as bridge parameters
+     * @param language Language to decode with; must outlive the returned struct
+     */
+    whisper_bridge_decode_params buildDecodeParams(const std::string &language) const;
+
+    /**
+     * @brief Pinned language, or the configured one
+     */
+    std::string decodeLanguage() const;
+
+    /**
+     * @brief Collect audio for language detection and pin the language once it is confident
+     */
+    void feedLanguageProbe(const float *samples, size_t count);
+
+    /**
+     * @brief Run detection on the probe and pin, re-pin or keep collecting
+     */
+    void detectSessionLanguage();
+
     /**
      * @brief Print system information and model details
      */
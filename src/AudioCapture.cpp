@@ -2,6 +2,7 @@
 #include <iostream>
 #include <cstring>
 #include <algorithm>
+#include <chrono>
 
 AudioCapture::AudioCapture()
     : AudioCapture(Config{}) // Delegate to the parametrized constructor
@@ -9,7 +10,8 @@ AudioCapture::AudioCapture()
 }
 
 AudioCapture::AudioCapture(const Config &config)
-    : config_(config), isCapturing_(false), audioBuffer_(nullptr)
+    : config_(config), isCapturing_(false), audioBuffer_(nullptr), dispatcherRunning_(false),
+      frameSamples_(0), streamStartTime_(-1.0), droppedSamples_(0), xrunCount_(0), streamRate_(config.sampleRate)
 {
 #ifdef USE_RTAUDIO
     // Initialize RtAudio here
@@ -33,6 +35,7 @@ AudioCapture::AudioCapture(const Config &config)
 AudioCapture::~AudioCapture()
 {
     stop();
+    stopDispatcher(); // A joinable thread must not be destroyed
 
 #ifdef USE_PORTAUDIO
     if (paStream_)
@@ -45,6 +48,8 @@ AudioCapture::~AudioCapture()
 
 bool AudioCapture::initialize()
 {
+    std::cout << "Sample conversion kernels: " << SampleConverter::backendName() << std::endl;
+
 #ifdef USE_RTAUDIO
     if (!rtAudio_)
     {
@@ -122,14 +127,14 @@ int AudioCapture::rtAudioCallback(void *outputBuffer, void *inputBuffer,
 
     auto *capture = static_cast<AudioCapture *>(userData);
 
-    if (status)
+    if (status && capture)
     {
-        std::cerr << "Stream underflow detected!" << std::endl;
+        capture->reportXrun(status);
     }
 
     if (capture && inputBuffer && capture->isCapturing_.load())
     {
-        capture->processAudioData(inputBuffer, nFrames, streamTime);
+        capture->pushToRing(inputBuffer, nFrames, streamTime);
     }
 
     return 0;
@@ -161,14 +166,14 @@ int AudioCapture::portAudioCallback(const void *inputBuffer, void *outputBuffer,
 
     auto *capture = static_cast<AudioCapture *>(userData);
 
-    if (statusFlags)
+    if (statusFlags && capture)
     {
-        std::cerr << "PortAudio status flags: " << statusFlags << std::endl;
+        capture->reportXrun(statusFlags);
     }
 
     if (capture && inputBuffer && capture->isCapturing_.load())
     {
-        capture->processAudioData(inputBuffer, framesPerBuffer, timeInfo->inputBufferAdcTime);
+        capture->pushToRing(inputBuffer, framesPerBuffer, timeInfo->inputBufferAdcTime);
     }
 
     return paContinue;
@@ -184,13 +189,21 @@ bool AudioCapture::start(AudioCallback callback)
 
     callback_ = callback;
 
+    // Frames go out by handle; the pool grows to the consumer's largest backlog and then stops allocating
+    frameSamples_ = std::max(1u, config_.sampleRate * config_.dispatchFrameMs / 1000);
+    if (!chunkPool_)
+    {
+        chunkPool_ = std::make_unique<AudioChunkPool>(frameSamples_, 64);
+    }
+
+    bool started = false;
 #ifdef USE_RTAUDIO
-    return startRtAudio();
+    started = startRtAudio();
 #elif defined(USE_PORTAUDIO)
-    return startPortAudio();
-#else
-    return false;
+    started = startPortAudio();
 #endif
+
+    return started;
 }
 
 #ifdef USE_RTAUDIO
@@ -222,6 +235,30 @@ bool AudioCapture::startRtAudio()
     inputParams.nChannels = config_.channels;
     inputParams.firstChannel = 0;
 
+    RtAudioFormat streamFormat = RTAUDIO_FLOAT32;
+    if (config_.sampleFormat == SampleFormat::Int16)
+    {
+        streamFormat = RTAUDIO_SINT16;
+    }
+    else if (config_.sampleFormat == SampleFormat::Int32)
+    {
+        streamFormat = RTAUDIO_SINT32;
+    }
+
+    // Prefer the target rate; otherwise open at the device's native rate and resample
+    unsigned int deviceRate = config_.deviceSampleRate;
+    if (deviceRate == 0)
+    {
+        const auto &rates = deviceInfo.sampleRates;
+        bool targetSupported = std::find(rates.begin(), rates.end(), config_.sampleRate) != rates.end();
+        deviceRate = targetSupported || deviceInfo.preferredSampleRate == 0 ? config_.sampleRate : deviceInfo.preferredSampleRate;
+    }
+
+    if (!configureStreamRate(deviceRate))
+    {
+        return false;
+    }
+
     RtAudio::StreamOptions options;
     options.flags = RTAUDIO_SCHEDULE_REALTIME;
     options.priority = 1;
@@ -231,14 +268,16 @@ bool AudioCapture::startRtAudio()
         rtAudio_->openStream(
             nullptr,             // No output
             &inputParams,        // Input parameters
-            RTAUDIO_FLOAT32,     // Sample format
-            config_.sampleRate,  // Sample rate
+            streamFormat,        // Sample format
+            streamRate_,         // Sample rate
             &config_.bufferSize, // Buffer size
             &rtAudioCallback,    // Callback
             this,                // User data
             &options             // Stream options
         );
 
+        startDispatcher();
+
         rtAudio_->startStream();
         isCapturing_.store(true);
 
@@ -248,6 +287,13 @@ bool AudioCapture::startRtAudio()
     catch (std::exception &e)
     {
         std::cerr << "RtAudio error: " << e.what() << std::endl;
+
+        // Nothing runs without isCapturing_, so stop() would not clean up after us
+        stopDispatcher();
+        if (rtAudio_->isStreamOpen())
+        {
+            rtAudio_->closeStream();
+        }
         return false;
     }
 }
@@ -265,14 +311,38 @@ bool AudioCapture::startPortAudio()
 
     inputParameters.channelCount = config_.channels;
     inputParameters.sampleFormat = paFloat32;
+    if (config_.sampleFormat == SampleFormat::Int16)
+    {
+        inputParameters.sampleFormat = paInt16;
+    }
+    else if (config_.sampleFormat == SampleFormat::Int32)
+    {
+        inputParameters.sampleFormat = paInt32;
+    }
     inputParameters.suggestedLatency = Pa_GetDeviceInfo(inputParameters.device)->defaultLowInputLatency;
     inputParameters.hostApiSpecificStreamInfo = nullptr;
 
+    // Prefer the target rate; otherwise open at the device's native rate and resample
+    unsigned int deviceRate = config_.deviceSampleRate;
+    if (deviceRate == 0)
+    {
+        deviceRate = config_.sampleRate;
+        if (Pa_IsFormatSupported(&inputParameters, nullptr, config_.sampleRate) != paFormatIsSupported)
+        {
+            deviceRate = static_cast<unsigned int>(Pa_GetDeviceInfo(inputParameters.device)->defaultSampleRate);
+        }
+    }
+
+    if (!configureStreamRate(deviceRate))
+    {
+        return false;
+    }
+
     PaError err = Pa_OpenStream(
         &paStream_,
         &inputParameters,
         nullptr, // No output
-        config_.sampleRate,
+        streamRate_,
         config_.bufferSize,
         paClipOff, // No clipping
         portAudioCallback,
@@ -284,10 +354,17 @@ bool AudioCapture::startPortAudio()
         return false;
     }
 
+    startDispatcher();
+
     err = Pa_StartStream(paStream_);
     if (err != paNoError)
     {
         std::cerr << "PortAudio error: " << Pa_GetErrorText(err) << std::endl;
+
+        // Nothing runs without isCapturing_, so stop() would not clean up after us
+        stopDispatcher();
+        Pa_CloseStream(paStream_);
+        paStream_ = nullptr;
         return false;
     }
 
@@ -322,6 +399,15 @@ void AudioCapture::stop()
         paStream_ = nullptr;
     }
 #endif
+
+    // The driver callback can no longer run, so the dispatcher can flush what is left
+    stopDispatcher();
+
+    if (droppedSamples_.load() > 0 || xrunCount_.load() > 0)
+    {
+        std::cerr << "Audio capture: " << droppedSamples_.load() << " samples dropped, "
+                  << xrunCount_.load() << " xruns reported" << std::endl;
+    }
 }
 
 bool AudioCapture::isCapturing() const
@@ -398,6 +484,16 @@ void AudioCapture::printAvailableDevices() const
 #endif
 }
 
+uint64_t AudioCapture::getDroppedSamples() const
+{
+    return droppedSamples_.load();
+}
+
+uint64_t AudioCapture::getXrunCount() const
+{
+    return xrunCount_.load();
+}
+
 bool AudioCapture::setDevice(unsigned int deviceId)
 {
     if (isCapturing_.load())
@@ -409,68 +505,211 @@ bool AudioCapture::setDevice(unsigned int deviceId)
     return true;
 }
 
-void AudioCapture::processAudioData(const void *inputBuffer, unsigned int frames, double timestamp)
+void AudioCapture::reportXrun(unsigned long flags)
 {
-    if (!inputBuffer || !callback_)
+    // No I/O on the driver thread; stop() reports the total
+    (void)flags;
+    xrunCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+unsigned int AudioCapture::getStreamSampleRate() const
+{
+    return streamRate_;
+}
+
+bool AudioCapture::configureStreamRate(unsigned int deviceRate)
+{
+    resampler_.reset();
+    streamRate_ = deviceRate;
+
+    if (deviceRate != config_.sampleRate)
+    {
+        if (!Resampler::isSupported(deviceRate, config_.sampleRate))
+        {
+            std::cerr << "Cannot resample from " << deviceRate << " Hz to " << config_.sampleRate << " Hz" << std::endl;
+            return false;
+        }
+
+        resampler_ = std::make_unique<Resampler>(deviceRate, config_.sampleRate,
+                                                 deviceRate * config_.dispatchFrameMs / 1000);
+        std::cout << "Opening device at " << deviceRate << " Hz, resampling to " << config_.sampleRate
+                  << " Hz (" << resampler_->getTapsPerPhase() << " taps/phase)" << std::endl;
+    }
+
+    // The ring holds device-rate audio; keep ~2 seconds of headroom
+    if (!audioBuffer_ || audioBuffer_->getSize() < deviceRate * 2)
+    {
+        audioBuffer_ = std::make_unique<AudioBuffer>(deviceRate * 2);
+    }
+
+    return true;
+}
+
+void AudioCapture::startDispatcher()
+{
+    if (dispatcherThread_.joinable() || !audioBuffer_)
     {
         return;
     }
 
-    // Convert input to float if necessary
-    std::vector<float> floatData = convertToFloat(inputBuffer, frames, RTAUDIO_FLOAT32);
+    // Everything the driver thread touches is allocated up front
+    scratch_.assign(std::max(config_.bufferSize, 256u), 0.0f);
+    dispatchFrame_ = chunkPool_->acquire(frameSamples_);
+    if (resampler_)
+    {
+        resampleInput_.assign(std::max(1u, streamRate_ * config_.dispatchFrameMs / 1000), 0.0f);
+        // Also large enough for the group-delay tail flushed at stop
+        resampleOutput_.assign(std::max(resampler_->maxOutputFor(resampleInput_.size()),
+                                        resampler_->maxOutputFor(resampler_->getTapsPerPhase())),
+                               0.0f);
+        resampler_->reset();
+    }
+    audioBuffer_->clear();
+    streamStartTime_.store(-1.0);
+    droppedSamples_.store(0);
+    xrunCount_.store(0);
+
+    dispatcherRunning_.store(true);
+    dispatcherThread_ = std::thread(&AudioCapture::dispatcherThreadFunction, this);
+}
 
-    // Call the user callback
-    if (!floatData.empty())
+void AudioCapture::stopDispatcher()
+{
+    if (!dispatcherThread_.joinable())
     {
-        callback_(floatData, timestamp);
+        return;
     }
+
+    dispatcherRunning_.store(false);
+    dispatcherThread_.join();
 }
 
-std::vector<float> AudioCapture::convertToFloat(const void *input, unsigned int frames, int format) const
+void AudioCapture::pushToRing(const void *inputBuffer, unsigned int frames, double timestamp)
 {
-    std::vector<float> output;
-    output.reserve(frames * config_.channels);
+    if (streamStartTime_.load(std::memory_order_relaxed) < 0.0)
+    {
+        streamStartTime_.store(timestamp, std::memory_order_relaxed);
+    }
 
-    if (format == RTAUDIO_FLOAT32)
+    const unsigned int channels = config_.channels;
+    const SampleFormat format = config_.sampleFormat;
+
+    if (channels == 1 && format == SampleFormat::Float32)
     {
-        const float *floatInput = static_cast<const float *>(input);
-        output.assign(floatInput, floatInput + frames * config_.channels);
+        size_t written = audioBuffer_->write(static_cast<const float *>(inputBuffer), frames);
+        if (written < frames)
+        {
+            droppedSamples_.fetch_add(frames - written, std::memory_order_relaxed);
+        }
+        return;
     }
-    else if (format == RTAUDIO_SINT16)
+
+    // Convert and downmix through the preallocated scratch buffer in pieces
+    const auto *input = static_cast<const uint8_t *>(inputBuffer);
+    const size_t frameBytes = SampleConverter::bytesPerSample(format) * channels;
+    const unsigned int chunkFrames = static_cast<unsigned int>(scratch_.size());
+    for (unsigned int offset = 0; offset < frames; offset += chunkFrames)
     {
-        const int16_t *shortInput = static_cast<const int16_t *>(input);
-        for (unsigned int i = 0; i < frames * config_.channels; i++)
+        const unsigned int n = std::min(chunkFrames, frames - offset);
+        SampleConverter::toMono(input + offset * frameBytes, format, n, channels, scratch_.data());
+
+        size_t written = audioBuffer_->write(scratch_.data(), n);
+        if (written < n)
         {
-            output.push_back(static_cast<float>(shortInput[i]) / 32768.0f);
+            droppedSamples_.fetch_add(n - written, std::memory_order_relaxed);
         }
     }
-    else if (format == RTAUDIO_SINT32)
+}
+
+void AudioCapture::deliverFrame(uint64_t &dispatchedSamples)
+{
+    double start = std::max(0.0, streamStartTime_.load());
+    double timestamp = start + static_cast<double>(dispatchedSamples) / config_.sampleRate;
+    const size_t count = dispatchFrame_->size();
+    dispatchFrame_->setTimestamp(timestamp);
+    if (callback_)
+    {
+        callback_(dispatchFrame_);
+    }
+    dispatchedSamples += count;
+
+    // The consumer may still hold the delivered frame
+    dispatchFrame_ = chunkPool_->acquire(frameSamples_);
+}
+
+void AudioCapture::appendToFrame(const float *samples, size_t count, size_t &filled, uint64_t &dispatchedSamples)
+{
+    const size_t frameSamples = frameSamples_;
+    while (count > 0)
     {
-        const int32_t *intInput = static_cast<const int32_t *>(input);
-        for (unsigned int i = 0; i < frames * config_.channels; i++)
+        const size_t take = std::min(count, frameSamples - filled);
+        std::memcpy(dispatchFrame_->data() + filled, samples, take * sizeof(float));
+        filled += take;
+        samples += take;
+        count -= take;
+
+        if (filled == frameSamples)
         {
-            output.push_back(static_cast<float>(intInput[i]) / 2147483648.0f);
+            deliverFrame(dispatchedSamples);
+            filled = 0;
         }
     }
+}
+
+void AudioCapture::dispatcherThreadFunction()
+{
+    const size_t frameSamples = frameSamples_;
+    const auto idleWait = std::chrono::milliseconds(std::max(1u, config_.dispatchFrameMs / 4));
+    size_t filled = 0;
+    uint64_t dispatchedSamples = 0;
 
-    // Convert to mono if needed
-    if (config_.channels > 1)
+    while (true)
     {
-        std::vector<float> mono;
-        mono.reserve(frames);
+        // Sample the flag before reading so the final drain sees everything written before stop
+        const bool running = dispatcherRunning_.load();
+        size_t read = 0;
 
-        for (unsigned int i = 0; i < frames; i++)
+        if (resampler_)
         {
-            float sum = 0.0f;
-            for (unsigned int ch = 0; ch < config_.channels; ch++)
+            read = audioBuffer_->read(resampleInput_.data(), resampleInput_.size());
+            size_t produced = resampler_->process(resampleInput_.data(), read, resampleOutput_.data(), resampleOutput_.size());
+            appendToFrame(resampleOutput_.data(), produced, filled, dispatchedSamples);
+        }
+        else
+        {
+            read = audioBuffer_->read(dispatchFrame_->data() + filled, frameSamples - filled);
+            filled += read;
+            if (filled == frameSamples)
             {
-                sum += output[i * config_.channels + ch];
+                deliverFrame(dispatchedSamples);
+                filled = 0;
             }
-            mono.push_back(sum / config_.channels);
         }
 
-        return mono;
+        if (read > 0)
+        {
+            continue;
+        }
+
+        if (!running)
+        {
+            break;
+        }
+
+        std::this_thread::sleep_for(idleWait);
+    }
+
+    // The ring is drained; push out the audio still held in the filter's delay line
+    if (resampler_)
+    {
+        size_t produced = resampler_->flush(resampleOutput_.data(), resampleOutput_.size());
+        appendToFrame(resampleOutput_.data(), produced, filled, dispatchedSamples);
     }
 
-    return output;
-}
\ No newline at end of file
+    // Flush the trailing partial frame
+    if (filled > 0)
+    {
+        dispatchFrame_->resize(filled);
+        deliverFrame(dispatchedSamples);
+    }
+}
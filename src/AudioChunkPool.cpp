@@ -0,0 +1,184 @@
+#include "AudioChunkPool.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+/**
+ * @brief Pool bookkeeping shared with outstanding chunks
+ *
+ * Lives until both the pool and every chunk it handed out are gone.
+ */
+struct AudioChunkPoolState
+{
+    std::mutex mutex;
+    std::vector<AudioChunk *> idle; ///< Capacity kept >= chunksAllocated so recycling never allocates
+    size_t chunkSamples = 0;
+    bool closed = false;            ///< The pool object was destroyed
+    AudioChunkPool::Stats stats;
+};
+
+AudioChunkPool::AudioChunkPool(size_t chunkSamples, size_t initialChunks)
+    : state_(new AudioChunkPoolState())
+{
+    state_->chunkSamples = std::max<size_t>(1, chunkSamples);
+
+    // Pre-warm the free list so the first seconds of streaming do not allocate either
+    std::vector<AudioChunkHandle> warm;
+    warm.reserve(initialChunks);
+    for (size_t i = 0; i < initialChunks; i++)
+    {
+        warm.push_back(acquire(state_->chunkSamples));
+    }
+}
+
+AudioChunkPool::~AudioChunkPool()
+{
+    bool destroy = false;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        for (AudioChunk *chunk : state_->idle)
+        {
+            delete chunk;
+        }
+        state_->idle.clear();
+        state_->closed = true;
+        destroy = state_->stats.inUse == 0;
+    }
+
+    // Otherwise the last recycled chunk frees the state
+    if (destroy)
+    {
+        delete state_;
+    }
+}
+
+AudioChunkHandle AudioChunkPool::acquire(size_t samples)
+{
+    AudioChunk *chunk = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stats.acquired++;
+        state_->stats.inUse++;
+
+        if (!state_->idle.empty())
+        {
+            chunk = state_->idle.back();
+            state_->idle.pop_back();
+        }
+        else
+        {
+            chunk = new AudioChunk();
+            chunk->pool_ = state_;
+            state_->stats.chunksAllocated++;
+            state_->idle.reserve(state_->stats.chunksAllocated);
+        }
+
+        if (chunk->capacity_ < samples || !chunk->samples_)
+        {
+            chunk->samples_.reset(new float[std::max(samples, state_->chunkSamples)]);
+            chunk->capacity_ = std::max(samples, state_->chunkSamples);
+            state_->stats.storageAllocations++;
+        }
+    }
+
+    chunk->size_ = samples;
+    chunk->timestamp_ = 0.0;
+    chunk->refs_.store(1, std::memory_order_relaxed);
+    return AudioChunkHandle(chunk);
+}
+
+AudioChunkHandle AudioChunkPool::copyOf(const float *samples, size_t count, double timestamp)
+{
+    AudioChunkHandle chunk = acquire(count);
+    if (count > 0)
+    {
+        std::memcpy(chunk->data(), samples, count * sizeof(float));
+    }
+    chunk->setTimestamp(timestamp);
+    return chunk;
+}
+
+AudioChunkPool::Stats AudioChunkPool::getStats() const
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    Stats stats = state_->stats;
+    stats.idle = state_->idle.size();
+    return stats;
+}
+
+void AudioChunkPool::recycle(AudioChunk *chunk)
+{
+    AudioChunkPoolState *state = chunk->pool_;
+    bool destroyState = false;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->stats.inUse--;
+        if (state->closed)
+        {
+            delete chunk;
+            destroyState = state->stats.inUse == 0;
+        }
+        else
+        {
+            state->idle.push_back(chunk);
+        }
+    }
+
+    if (destroyState)
+    {
+        delete state;
+    }
+}
+
+AudioChunkQueue::AudioChunkQueue(size_t initialCapacity)
+    : slots_(std::max<size_t>(1, initialCapacity)), head_(0), count_(0)
+{
+}
+
+void AudioChunkQueue::push(AudioChunkHandle chunk)
+{
+    if (count_ == slots_.size())
+    {
+        // Unwrap into a ring twice the size
+        std::vector<AudioChunkHandle> grown(slots_.size() * 2);
+        for (size_t i = 0; i < count_; i++)
+        {
+            grown[i] = std::move(slots_[(head_ + i) % slots_.size()]);
+        }
+        slots_.swap(grown);
+        head_ = 0;
+    }
+
+    slots_[(head_ + count_) % slots_.size()] = std::move(chunk);
+    count_++;
+}
+
+bool AudioChunkQueue::pop(AudioChunkHandle &chunk)
+{
+    if (count_ == 0)
+    {
+        return false;
+    }
+
+    chunk = std::move(slots_[head_]);
+    head_ = (head_ + 1) % slots_.size();
+    count_--;
+    return true;
+}
+
+void AudioChunkQueue::clear()
+{
+    AudioChunkHandle chunk;
+    while (pop(chunk))
+    {
+        chunk.reset();
+    }
+    head_ = 0;
+}
+
+void AudioChunkQueue::swap(AudioChunkQueue &other) noexcept
+{
+    slots_.swap(other.slots_);
+    std::swap(head_, other.head_);
+    std::swap(count_, other.count_);
+}
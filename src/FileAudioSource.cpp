@@ -0,0 +1,521 @@
+#include "FileAudioSource.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+    constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+    constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+    uint16_t readLe16(const uint8_t *p)
+    {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    uint32_t readLe32(const uint8_t *p)
+    {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    /**
+     * @brief read(2) that retries on EINTR and short reads
+     * @return Bytes read; less than size only at end of input or on error
+     */
+    size_t readFully(int fd, void *dst, size_t size)
+    {
+        auto *out = static_cast<uint8_t *>(dst);
+        size_t total = 0;
+        while (total < size)
+        {
+            ssize_t n = ::read(fd, out + total, size - total);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                break;
+            }
+            total += static_cast<size_t>(n);
+        }
+        return total;
+    }
+}
+
+FileAudioSource::FileAudioSource(const Config &config)
+    : config_(config), running_(false), isCapturing_(false), samplesDelivered_(0),
+      inputFormat_(config.rawSampleFormat), inputRate_(config.rawSampleRate), inputChannels_(config.rawChannels),
+      frameBytes_(0), fd_(-1), mapping_(nullptr), mappingSize_(0), position_(0), dataBegin_(0), dataEnd_(0),
+      useStdin_(config.path == "-"), stdinFill_(0), frameSamples_(0)
+{
+}
+
+FileAudioSource::~FileAudioSource()
+{
+    stop();
+    closeInput();
+}
+
+bool FileAudioSource::initialize()
+{
+    if (!(useStdin_ ? openStdin() : openFile()))
+    {
+        return false;
+    }
+
+    if (!prepareConversion())
+    {
+        return false;
+    }
+
+    std::cout << "Audio input: " << (useStdin_ ? "stdin" : config_.path) << " (" << inputRate_ << " Hz, "
+              << inputChannels_ << " ch, " << SampleConverter::bytesPerSample(inputFormat_) * 8 << "-bit"
+              << (config_.maxSpeed ? ", max speed" : ", real time") << ")" << std::endl;
+    return true;
+}
+
+bool FileAudioSource::openFile()
+{
+    fd_ = ::open(config_.path.c_str(), O_RDONLY);
+    if (fd_ < 0)
+    {
+        std::cerr << "Failed to open audio file " << config_.path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || st.st_size <= 0)
+    {
+        std::cerr << "Audio file is empty or unreadable: " << config_.path << std::endl;
+        return false;
+    }
+
+    mappingSize_ = static_cast<size_t>(st.st_size);
+    void *mapping = mmap(nullptr, mappingSize_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "Failed to map audio file " << config_.path << ": " << std::strerror(errno) << std::endl;
+        mappingSize_ = 0;
+        return false;
+    }
+    mapping_ = static_cast<const uint8_t *>(mapping);
+    madvise(mapping, mappingSize_, MADV_SEQUENTIAL);
+
+    position_ = 0;
+    dataBegin_ = 0;
+    dataEnd_ = mappingSize_;
+
+    const bool isWav = mappingSize_ >= 12 && std::memcmp(mapping_, "RIFF", 4) == 0 && std::memcmp(mapping_ + 8, "WAVE", 4) == 0;
+    if (config_.format == InputFormat::Raw || (config_.format == InputFormat::Auto && !isWav))
+    {
+        return true;
+    }
+
+    position_ = 12; // RIFF size + WAVE tag
+    auto readMapped = [this](void *dst, size_t size)
+    {
+        if (size > mappingSize_ - position_)
+        {
+            return false;
+        }
+        if (dst)
+        {
+            std::memcpy(dst, mapping_ + position_, size);
+        }
+        position_ += size;
+        return true;
+    };
+
+    uint32_t dataBytes = 0;
+    if (!parseWavHeader(readMapped, dataBytes))
+    {
+        return false;
+    }
+
+    // Streaming writers leave the size at 0 or 0xFFFFFFFF; fall back to the end of the file
+    if (dataBytes != 0 && dataBytes != 0xFFFFFFFFu)
+    {
+        dataEnd_ = std::min(mappingSize_, position_ + dataBytes);
+    }
+    dataBegin_ = position_;
+    return true;
+}
+
+bool FileAudioSource::openStdin()
+{
+    // Peek at the first 12 bytes; for raw input they are the start of the audio
+    uint8_t riff[12];
+    size_t got = readFully(STDIN_FILENO, riff, sizeof(riff));
+
+    const bool isWav = got == sizeof(riff) && std::memcmp(riff, "RIFF", 4) == 0 && std::memcmp(riff + 8, "WAVE", 4) == 0;
+    if (config_.format == InputFormat::Raw || (config_.format == InputFormat::Auto && !isWav))
+    {
+        stdinBuffer_.assign(riff, riff + got);
+        stdinFill_ = got;
+        return true;
+    }
+
+    auto readStdin = [](void *dst, size_t size)
+    {
+        if (dst)
+        {
+            return readFully(STDIN_FILENO, dst, size) == size;
+        }
+        uint8_t discard[256];
+        while (size > 0)
+        {
+            size_t chunk = std::min(size, sizeof(discard));
+            if (readFully(STDIN_FILENO, discard, chunk) != chunk)
+            {
+                return false;
+            }
+            size -= chunk;
+        }
+        return true;
+    };
+
+    // The RIFF header was already consumed; the data chunk size is ignored and stdin is read to EOF
+    uint32_t dataBytes = 0;
+    return parseWavHeader(readStdin, dataBytes);
+}
+
+bool FileAudioSource::parseWavHeader(const std::function<bool(void *, size_t)> &read, uint32_t &dataBytes)
+{
+    bool haveFormat = false;
+    while (true)
+    {
+        uint8_t chunk[8];
+        if (!read(chunk, sizeof(chunk)))
+        {
+            std::cerr << "WAV input has no data chunk" << std::endl;
+            return false;
+        }
+        const uint32_t chunkSize = readLe32(chunk + 4);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0)
+        {
+            uint8_t fmt[40] = {};
+            const size_t fmtBytes = std::min<size_t>(chunkSize, sizeof(fmt));
+            if (chunkSize < 16 || !read(fmt, fmtBytes) || !read(nullptr, chunkSize - fmtBytes + (chunkSize & 1)))
+            {
+                std::cerr << "Invalid WAV fmt chunk" << std::endl;
+                return false;
+            }
+
+            uint16_t tag = readLe16(fmt);
+            inputChannels_ = readLe16(fmt + 2);
+            inputRate_ = readLe32(fmt + 4);
+            const uint16_t bits = readLe16(fmt + 14);
+            if (tag == WAVE_FORMAT_EXTENSIBLE && fmtBytes >= 26)
+            {
+                tag = readLe16(fmt + 24); // First two bytes of the SubFormat GUID
+            }
+
+            if (tag == WAVE_FORMAT_PCM && bits == 16)
+            {
+                inputFormat_ = SampleFormat::Int16;
+            }
+            else if (tag == WAVE_FORMAT_PCM && bits == 32)
+            {
+                inputFormat_ = SampleFormat::Int32;
+            }
+            else if (tag == WAVE_FORMAT_IEEE_FLOAT && bits == 32)
+            {
+                inputFormat_ = SampleFormat::Float32;
+            }
+            else
+            {
+                std::cerr << "Unsupported WAV encoding (format " << tag << ", " << bits << "-bit)" << std::endl;
+                return false;
+            }
+            haveFormat = true;
+        }
+        else if (std::memcmp(chunk, "data", 4) == 0)
+        {
+            if (!haveFormat)
+            {
+                std::cerr << "WAV data chunk precedes fmt chunk" << std::endl;
+                return false;
+            }
+            dataBytes = chunkSize;
+            return true;
+        }
+        else if (!read(nullptr, chunkSize + (chunkSize & 1)))
+        {
+            std::cerr << "Truncated WAV chunk" << std::endl;
+            return false;
+        }
+    }
+}
+
+bool FileAudioSource::prepareConversion()
+{
+    if (inputChannels_ == 0 || inputRate_ == 0)
+    {
+        std::cerr << "Invalid input layout: " << inputRate_ << " Hz, " << inputChannels_ << " channels" << std::endl;
+        return false;
+    }
+
+    if (inputRate_ != config_.sampleRate)
+    {
+        if (!Resampler::isSupported(inputRate_, config_.sampleRate))
+        {
+            std::cerr << "Cannot resample from " << inputRate_ << " Hz to " << config_.sampleRate << " Hz" << std::endl;
+            return false;
+        }
+    }
+
+    frameBytes_ = SampleConverter::bytesPerSample(inputFormat_) * inputChannels_;
+
+    // Input is converted in blocks of one output frame's duration
+    const size_t blockFrames = std::max<size_t>(1, static_cast<size_t>(inputRate_) * config_.frameMs / 1000);
+    mono_.assign(blockFrames, 0.0f);
+    if (inputRate_ != config_.sampleRate)
+    {
+        resampler_ = std::make_unique<Resampler>(inputRate_, config_.sampleRate, blockFrames);
+        resampled_.assign(resampler_->maxOutputFor(blockFrames), 0.0f);
+    }
+    frameSamples_ = std::max(1u, config_.sampleRate * config_.frameMs / 1000);
+    chunkPool_ = std::make_unique<AudioChunkPool>(frameSamples_, 64);
+
+    if (useStdin_)
+    {
+        stdinBuffer_.resize(std::max(stdinBuffer_.size(), blockFrames * frameBytes_));
+    }
+
+    return true;
+}
+
+bool FileAudioSource::start(AudioCallback callback)
+{
+    if (isCapturing_.load())
+    {
+        return true;
+    }
+
+    if (!chunkPool_)
+    {
+        std::cerr << "FileAudioSource not initialized" << std::endl;
+        return false;
+    }
+
+    callback_ = callback;
+    frame_ = chunkPool_->acquire(frameSamples_);
+    samplesDelivered_.store(0);
+    running_.store(true);
+    isCapturing_.store(true);
+    readerThread_ = std::thread(&FileAudioSource::readerThreadFunction, this);
+    return true;
+}
+
+void FileAudioSource::stop()
+{
+    running_.store(false);
+    if (readerThread_.joinable())
+    {
+        readerThread_.join();
+    }
+    isCapturing_.store(false);
+}
+
+bool FileAudioSource::isCapturing() const
+{
+    return isCapturing_.load();
+}
+
+void FileAudioSource::setPendingSamplesProvider(std::function<size_t()> provider)
+{
+    pendingProvider_ = std::move(provider);
+}
+
+uint64_t FileAudioSource::getSamplesDelivered() const
+{
+    return samplesDelivered_.load();
+}
+
+double FileAudioSource::getDurationSeconds() const
+{
+    if (useStdin_ || frameBytes_ == 0)
+    {
+        return -1.0;
+    }
+    return static_cast<double>((dataEnd_ - dataBegin_) / frameBytes_) / inputRate_;
+}
+
+size_t FileAudioSource::readStdinFrames(size_t maxFrames)
+{
+    const size_t want = maxFrames * frameBytes_;
+
+    // Poll with a timeout so stop() is honored while stdin is idle
+    while (stdinFill_ < want && running_.load())
+    {
+        struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+        int ready = poll(&pfd, 1, 100);
+        if (ready < 0 && errno != EINTR)
+        {
+            break;
+        }
+        if (ready <= 0)
+        {
+            continue;
+        }
+
+        ssize_t n = ::read(STDIN_FILENO, stdinBuffer_.data() + stdinFill_, want - stdinFill_);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            break; // End of input
+        }
+        stdinFill_ += static_cast<size_t>(n);
+    }
+
+    return std::min(maxFrames, stdinFill_ / frameBytes_);
+}
+
+void FileAudioSource::readerThreadFunction()
+{
+    const size_t blockFrames = mono_.size();
+    size_t filled = 0;
+    startTime_ = std::chrono::steady_clock::now();
+
+    while (running_.load())
+    {
+        const uint8_t *block = nullptr;
+        size_t frames = 0;
+
+        if (useStdin_)
+        {
+            frames = readStdinFrames(blockFrames);
+            block = stdinBuffer_.data();
+        }
+        else
+        {
+            frames = std::min(blockFrames, (dataEnd_ - position_) / frameBytes_);
+            block = mapping_ + position_;
+            position_ += frames * frameBytes_;
+        }
+
+        if (frames == 0)
+        {
+            break; // End of input
+        }
+
+        SampleConverter::toMono(block, inputFormat_, frames, inputChannels_, mono_.data());
+
+        if (useStdin_)
+        {
+            // Keep a trailing partial frame for the next read
+            const size_t used = frames * frameBytes_;
+            std::memmove(stdinBuffer_.data(), stdinBuffer_.data() + used, stdinFill_ - used);
+            stdinFill_ -= used;
+        }
+
+        if (resampler_)
+        {
+            size_t produced = resampler_->process(mono_.data(), frames, resampled_.data(), resampled_.size());
+            appendToFrame(resampled_.data(), produced, filled);
+        }
+        else
+        {
+            appendToFrame(mono_.data(), frames, filled);
+        }
+    }
+
+    // Drain the resampler's delay line so the last few milliseconds are not lost
+    if (resampler_ && running_.load())
+    {
+        size_t produced = resampler_->flush(resampled_.data(), resampled_.size());
+        appendToFrame(resampled_.data(), produced, filled);
+    }
+
+    // Flush the trailing partial frame
+    if (filled > 0 && running_.load())
+    {
+        frame_->resize(filled);
+        deliverFrame();
+    }
+
+    if (running_.load())
+    {
+        std::cout << "Audio input finished: " << static_cast<double>(samplesDelivered_.load()) / config_.sampleRate
+                  << " s delivered" << std::endl;
+    }
+    isCapturing_.store(false);
+}
+
+void FileAudioSource::appendToFrame(const float *samples, size_t count, size_t &filled)
+{
+    const size_t frameSamples = frameSamples_;
+    while (count > 0 && running_.load())
+    {
+        const size_t take = std::min(count, frameSamples - filled);
+        std::memcpy(frame_->data() + filled, samples, take * sizeof(float));
+        filled += take;
+        samples += take;
+        count -= take;
+
+        if (filled == frameSamples)
+        {
+            deliverFrame();
+            filled = 0;
+        }
+    }
+}
+
+void FileAudioSource::deliverFrame()
+{
+    const uint64_t delivered = samplesDelivered_.load();
+
+    if (config_.maxSpeed)
+    {
+        // Flow control: let the consumer drain its backlog before queueing more
+        while (pendingProvider_ && running_.load() && pendingProvider_() > config_.maxPendingSamples)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    else
+    {
+        const auto due = startTime_ + std::chrono::microseconds(delivered * 1000000 / config_.sampleRate);
+        std::this_thread::sleep_until(due);
+    }
+
+    const size_t count = frame_->size();
+    frame_->setTimestamp(static_cast<double>(delivered) / config_.sampleRate);
+    if (callback_)
+    {
+        callback_(frame_);
+    }
+    samplesDelivered_.store(delivered + count);
+
+    // The consumer may still hold the delivered frame
+    frame_ = chunkPool_->acquire(frameSamples_);
+}
+
+void FileAudioSource::closeInput()
+{
+    if (mapping_)
+    {
+        munmap(const_cast<uint8_t *>(mapping_), mappingSize_);
+        mapping_ = nullptr;
+        mappingSize_ = 0;
+    }
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
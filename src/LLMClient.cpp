@@ -8,6 +8,109 @@
 #include <vector>
 #include <string>
 #include <ctime>
+#include <utility>
+
+namespace
+{
+    // Prompts are split where the request-specific text starts, so their fixed heads can be cached
+    const char *const kSummarySystemPrompt = "You are a helpful assistant that creates concise summaries of lecture transcripts. Always end your summary with a clear conclusion.";
+
+    const char *const kSummaryInstructions = "Summarize this university lecture transcript using this EXACT format:\n\n"
+                                             "## Key Concepts and Definitions:\n"
+                                             "[List the main concepts and their definitions here]\n\n"
+                                             "## Important Formulas or Theories:\n"
+                                             "[List any formulas, theories, or scientific principles mentioned]\n\n"
+                                             "## Examples Given by the Professor:\n"
+                                             "[List specific examples or case studies mentioned]\n\n"
+                                             "## Potential Exam Topics:\n"
+                                             "[List topics that would likely appear on an exam]\n\n"
+                                             "Transcript:\n\n";
+
+    const char *const kSummaryClosing = "\n\nUse the exact section headers shown above and organize your response accordingly."
+                                        "\n\nAfter providing the summary with the above mentioned format, end with 'Summary complete.'";
+
+    const char *const kNotesSystemPrompt = "You are a helpful assistant that takes notes on parts of lecture transcripts.";
+
+    const char *const kNotesInstructions = "Write concise notes on this part of a university lecture transcript. "
+                                           "List the concepts and definitions, formulas or theories, examples given by the professor "
+                                           "and anything stressed as important for the exam, as short bullet points.\n\n"
+                                           "Transcript part:\n\n";
+
+    // Stands in for the transcript when the summary is written from chunk notes
+    const char *const kNotesHeader = "(Notes taken on consecutive parts of the lecture, in order)\n\n";
+
+    const char *const kChatSystemPrompt = "You are a helpful assistant that answers questions based on lecture content.";
+
+    const char *const kChatContextLabel = "Context: ";
+
+    /**
+     * @brief Check whether text ends on a complete UTF-8 code point
+     */
+    bool endsOnCodePoint(const std::string &text)
+    {
+        // Find the lead byte of the last code point and compare its length with what follows it
+        size_t lead = text.size();
+        while (lead > 0 && text.size() - lead < 4)
+        {
+            lead--;
+            const unsigned char byte = static_cast<unsigned char>(text[lead]);
+            if ((byte & 0xC0) != 0x80)
+            {
+                const size_t length = byte < 0x80 ? 1 : (byte & 0xE0) == 0xC0 ? 2 : (byte & 0xF0) == 0xE0 ? 3 : 4;
+                return text.size() - lead >= length;
+            }
+        }
+        return lead == text.size();
+    }
+
+    /**
+     * @brief Forward bridge text pieces to an LLMClient::TokenCallback
+     */
+    bool forwardPiece(const char *piece, int length, void *userData)
+    {
+        auto *callback = static_cast<LLMClient::TokenCallback *>(userData);
+        return (*callback)(std::string(piece, length));
+    }
+
+    /**
+     * @brief Forward bridge prefill progress to an LLMClient::ProgressCallback
+     */
+    void forwardProgress(int done, int total, void *userData)
+    {
+        auto *callback = static_cast<LLMClient::ProgressCallback *>(userData);
+        if (*callback)
+        {
+            (*callback)(done, total);
+        }
+    }
+
+    /**
+     * @brief Copy a bridge result into a Response and free it
+     */
+    LLMClient::Response toResponse(llama_bridge_result &bridgeResult)
+    {
+        LLMClient::Response result;
+        result.success = bridgeResult.success;
+
+        if (bridgeResult.success)
+        {
+            result.text = bridgeResult.text ? std::string(bridgeResult.text) : "";
+            result.tokensGenerated = bridgeResult.tokens_generated;
+            result.inferenceTimeMs = bridgeResult.inference_time_ms;
+            result.timeToFirstTokenMs = bridgeResult.time_to_first_token_ms;
+            result.promptTokens = bridgeResult.prompt_tokens;
+            result.cachedPromptTokens = bridgeResult.prompt_tokens_cached;
+        }
+        else
+        {
+            result.error = bridgeResult.error_msg ? std::string(bridgeResult.error_msg) : "Unknown error";
+        }
+
+        // Clean up bridge result
+        llama_bridge_free_result(&bridgeResult);
+        return result;
+    }
+}
 
 LLMClient::LLMClient(const Config &config)
     : config_(config), model_(nullptr), context_(nullptr), initialized_(false)
@@ -46,13 +149,46 @@ bool LLMClient::initialize()
     params.temperature = config_.temperature;
     params.top_p = config_.topP;
     params.verbose = config_.verbose;
+    params.prefault = config_.prefaultModel;
+    params.max_sessions = config_.maxSessions;
+    params.max_parallel = config_.summaryChunkTokens > 0 ? config_.summaryParallel : 0;
+    params.batch_size = config_.batchSize;
+    params.ubatch_size = config_.ubatchSize;
 
+    const auto loadStart = std::chrono::steady_clock::now();
     llama_bridge_context *bridge_ctx = llama_bridge_init(params);
     if (!bridge_ctx)
     {
         std::cerr << "❌ Failed to initialize LLM bridge" << std::endl;
         return false;
     }
+    startup_.loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+
+    // The first request would otherwise allocate compute buffers and fault in the weights
+    if (config_.warmup)
+    {
+        const auto warmupStart = std::chrono::steady_clock::now();
+        if (!llama_bridge_warmup(bridge_ctx))
+        {
+            std::cerr << "⚠️  LLM warm-up decode failed" << std::endl;
+        }
+        startup_.warmupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - warmupStart).count();
+    }
+
+    // Summaries and answers then only prefill the transcript or context that follows these heads
+    if (config_.cachePromptPrefixes)
+    {
+        const auto cacheStart = std::chrono::steady_clock::now();
+        if (!llama_bridge_cache_chat_prefix(bridge_ctx, kSummarySystemPrompt, kSummaryInstructions) ||
+            !llama_bridge_cache_chat_prefix(bridge_ctx, kNotesSystemPrompt, kNotesInstructions) ||
+            !llama_bridge_cache_chat_prefix(bridge_ctx, kChatSystemPrompt, kChatContextLabel))
+        {
+            std::cerr << "⚠️  Failed to cache the prompt prefixes; every request prefills its whole prompt" << std::endl;
+        }
+        startup_.warmupMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cacheStart).count();
+    }
+
+    llama_bridge_set_progress_callback(bridge_ctx, &forwardProgress, &prefillProgress_);
 
     context_ = reinterpret_cast<llama_context *>(bridge_ctx);
     model_ = nullptr; // Not used with bridge API
@@ -61,34 +197,77 @@ bool LLMClient::initialize()
     return true;
 }
 
-LLMClient::Response LLMClient::summarizeTranscript(const std::string &transcript)
+LLMClient::Response LLMClient::summarizeTranscript(const std::string &transcript, TokenCallback onToken)
 {
     if (!initialized_)
     {
         return {.success = false, .error = "LLM not initialized"};
     }
 
-    // Use chat format optimized for small models with explicit stopping
-    std::string system_prompt = "You are a helpful assistant that creates concise summaries of lecture transcripts. Always end your summary with a clear conclusion.";
+    const auto start = std::chrono::steady_clock::now();
+
+    // Map: a transcript too long for one prompt is condensed chunk by chunk, all chunks in flight at
+    // once; repeated while the notes are still too long. Attention cost and KV cells stay bounded.
+    std::string material = transcript;
+    std::vector<llama_token> tokens;
+    if (config_.summaryChunkTokens > 0)
+    {
+        tokens = tokenize(material);
+    }
+
+    bool condensed = false;
+    Response notesStats{};
+    while (config_.summaryChunkTokens > 0 && tokens.size() > static_cast<size_t>(config_.summaryChunkTokens))
+    {
+        std::vector<std::string> messages;
+        for (const auto &chunk : splitIntoChunks(tokens, config_.summaryChunkTokens))
+        {
+            messages.push_back(kNotesInstructions + chunk);
+        }
+
+        std::vector<Response> notes = chatBatch(kNotesSystemPrompt, messages, config_.summaryNoteTokens);
+        std::string joined;
+        for (size_t i = 0; i < notes.size(); i++)
+        {
+            if (!notes[i].success)
+            {
+                return {.success = false, .error = "Failed to summarize transcript part " + std::to_string(i + 1) + ": " + notes[i].error};
+            }
+            joined += "Part " + std::to_string(i + 1) + ":\n" + notes[i].text + "\n\n";
+            notesStats.tokensGenerated += notes[i].tokensGenerated;
+            notesStats.promptTokens += notes[i].promptTokens;
+            notesStats.cachedPromptTokens += notes[i].cachedPromptTokens;
+        }
 
-    std::string user_message = "Summarize this university lecture transcript using this EXACT format:\n\n"
-                               "## Key Concepts and Definitions:\n"
-                               "[List the main concepts and their definitions here]\n\n"
-                               "## Important Formulas or Theories:\n"
-                               "[List any formulas, theories, or scientific principles mentioned]\n\n"
-                               "## Examples Given by the Professor:\n"
-                               "[List specific examples or case studies mentioned]\n\n"
-                               "## Potential Exam Topics:\n"
-                               "[List topics that would likely appear on an exam]\n\n"
-                               "Transcript:\n\n" +
-                               transcript +
-                               "\n\nUse the exact section headers shown above and organize your response accordingly." +
-                               "\n\nAfter providing the summary with the above mentioned format, end with 'Summary complete.'";
+        std::vector<llama_token> condensedTokens = tokenize(joined);
+        const bool shrunk = condensedTokens.size() < tokens.size();
+        material = std::move(joined);
+        tokens = std::move(condensedTokens);
+        condensed = true;
+        if (!shrunk)
+        {
+            break;
+        }
+    }
+    const double mapMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 
-    return chat(system_prompt, user_message, 4096); // Optimized tokens for longer summaries
+    // Reduce: use chat format optimized for small models with explicit stopping
+    std::string user_message = kSummaryInstructions + (condensed ? kNotesHeader : std::string()) + material + kSummaryClosing;
+
+    Response result = chat(kSummarySystemPrompt, user_message, 4096, onToken); // Optimized tokens for longer summaries
+    if (result.success && condensed)
+    {
+        // Account for the whole request; the first summary token came after the map phase
+        result.tokensGenerated += notesStats.tokensGenerated;
+        result.promptTokens += notesStats.promptTokens;
+        result.cachedPromptTokens += notesStats.cachedPromptTokens;
+        result.timeToFirstTokenMs += mapMs;
+        result.inferenceTimeMs += mapMs;
+    }
+    return result;
 }
 
-LLMClient::Response LLMClient::chatWithContext(const std::string &question, const std::string &context)
+LLMClient::Response LLMClient::chatWithContext(const std::string &question, const std::string &context, TokenCallback onToken)
 {
     if (!initialized_)
     {
@@ -96,11 +275,58 @@ LLMClient::Response LLMClient::chatWithContext(const std::string &question, cons
     }
 
     // Use chat format for better context understanding
-    std::string system_prompt = "You are a helpful assistant that answers questions based on lecture content.";
+    std::string user_message = kChatContextLabel + context + "\n\nQuestion: " + question;
 
-    std::string user_message = "Context: " + context + "\n\nQuestion: " + question;
+    return chat(kChatSystemPrompt, user_message, config_.maxTokens, onToken);
+}
+
+int LLMClient::createSession()
+{
+    if (!initialized_ || !context_)
+        return -1;
+    return llama_bridge_session_create(reinterpret_cast<llama_bridge_context *>(context_));
+}
 
-    return chat(system_prompt, user_message, config_.maxTokens);
+int LLMClient::forkSession(int session)
+{
+    if (!initialized_ || !context_)
+        return -1;
+    return llama_bridge_session_fork(reinterpret_cast<llama_bridge_context *>(context_), session);
+}
+
+bool LLMClient::resetSession(int session)
+{
+    if (!initialized_ || !context_)
+        return false;
+    return llama_bridge_session_reset(reinterpret_cast<llama_bridge_context *>(context_), session);
+}
+
+void LLMClient::destroySession(int session)
+{
+    if (!initialized_ || !context_)
+        return;
+    llama_bridge_session_destroy(reinterpret_cast<llama_bridge_context *>(context_), session);
+}
+
+LLMClient::Response LLMClient::chatInSession(int session, const std::string &message, TokenCallback onToken)
+{
+    if (!initialized_ || !context_)
+    {
+        return {.success = false, .error = "LLM not properly initialized"};
+    }
+
+    // The system prompt only goes into the first turn; later turns append to what the session holds
+    llama_bridge_context *bridge_ctx = reinterpret_cast<llama_bridge_context *>(context_);
+    llama_bridge_result bridge_result = llama_bridge_session_chat(bridge_ctx, session, kChatSystemPrompt, message.c_str(),
+                                                                  config_.maxTokens, onToken ? &forwardPiece : nullptr,
+                                                                  onToken ? &onToken : nullptr);
+
+    return toResponse(bridge_result);
+}
+
+void LLMClient::setPrefillProgressCallback(ProgressCallback callback)
+{
+    prefillProgress_ = std::move(callback);
 }
 
 bool LLMClient::isInitialized() const
@@ -108,7 +334,12 @@ bool LLMClient::isInitialized() const
     return initialized_;
 }
 
-LLMClient::Response LLMClient::generate(const std::string &prompt, int maxTokens)
+LLMClient::StartupTimeline LLMClient::getStartupTimeline() const
+{
+    return startup_;
+}
+
+LLMClient::Response LLMClient::generate(const std::string &prompt, int maxTokens, TokenCallback onToken)
 {
     auto start = std::chrono::high_resolution_clock::now();
 
@@ -122,24 +353,11 @@ LLMClient::Response LLMClient::generate(const std::string &prompt, int maxTokens
 
     // Use the bridge API for generation
     llama_bridge_context *bridge_ctx = reinterpret_cast<llama_bridge_context *>(context_);
-    llama_bridge_result bridge_result = llama_bridge_generate(bridge_ctx, prompt.c_str(), maxTokens);
+    llama_bridge_result bridge_result = onToken
+                                            ? llama_bridge_generate_stream(bridge_ctx, prompt.c_str(), maxTokens, &forwardPiece, &onToken)
+                                            : llama_bridge_generate(bridge_ctx, prompt.c_str(), maxTokens);
 
-    Response result;
-    result.success = bridge_result.success;
-
-    if (bridge_result.success)
-    {
-        result.text = bridge_result.text ? std::string(bridge_result.text) : "";
-        result.tokensGenerated = bridge_result.tokens_generated;
-        result.inferenceTimeMs = bridge_result.inference_time_ms;
-    }
-    else
-    {
-        result.error = bridge_result.error_msg ? std::string(bridge_result.error_msg) : "Unknown error";
-    }
-
-    // Clean up bridge result
-    llama_bridge_free_result(&bridge_result);
+    Response result = toResponse(bridge_result);
 
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
@@ -147,11 +365,16 @@ LLMClient::Response LLMClient::generate(const std::string &prompt, int maxTokens
     {
         result.inferenceTimeMs = static_cast<double>(duration.count());
     }
+    if (startup_.firstResultMs < 0.0)
+    {
+        startup_.firstResultMs = std::chrono::duration<double, std::milli>(end - start).count();
+    }
 
     return result;
 }
 
-LLMClient::Response LLMClient::chat(const std::string &system_prompt, const std::string &user_message, int maxTokens)
+LLMClient::Response LLMClient::chat(const std::string &system_prompt, const std::string &user_message, int maxTokens,
+                                    TokenCallback onToken)
 {
     auto start = std::chrono::high_resolution_clock::now();
 
@@ -165,33 +388,105 @@ LLMClient::Response LLMClient::chat(const std::string &system_prompt, const std:
 
     // Use the bridge chat API with proper Qwen formatting
     llama_bridge_context *bridge_ctx = reinterpret_cast<llama_bridge_context *>(context_);
-    llama_bridge_result bridge_result = llama_bridge_chat(bridge_ctx, system_prompt.c_str(), user_message.c_str(), maxTokens);
+    llama_bridge_result bridge_result = onToken
+                                            ? llama_bridge_chat_stream(bridge_ctx, system_prompt.c_str(), user_message.c_str(), maxTokens,
+                                                                       &forwardPiece, &onToken)
+                                            : llama_bridge_chat(bridge_ctx, system_prompt.c_str(), user_message.c_str(), maxTokens);
+
+    Response result = toResponse(bridge_result);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    if (result.success && result.inferenceTimeMs == 0.0)
+    {
+        result.inferenceTimeMs = static_cast<double>(duration.count());
+    }
+    if (startup_.firstResultMs < 0.0)
+    {
+        startup_.firstResultMs = std::chrono::duration<double, std::milli>(end - start).count();
+    }
 
-    Response result;
-    result.success = bridge_result.success;
+    return result;
+}
 
-    if (bridge_result.success)
+std::vector<LLMClient::Response> LLMClient::chatBatch(const std::string &system_prompt,
+                                                      const std::vector<std::string> &user_messages, int maxTokens)
+{
+    std::vector<Response> responses;
+    if (!initialized_ || !context_)
     {
-        result.text = bridge_result.text ? std::string(bridge_result.text) : "";
-        result.tokensGenerated = bridge_result.tokens_generated;
-        result.inferenceTimeMs = bridge_result.inference_time_ms;
+        responses.assign(user_messages.size(), {.success = false, .error = "LLM not properly initialized"});
+        return responses;
     }
-    else
+
+    std::vector<const char *> messages;
+    for (const auto &message : user_messages)
     {
-        result.error = bridge_result.error_msg ? std::string(bridge_result.error_msg) : "Unknown error";
+        messages.push_back(message.c_str());
     }
 
-    // Clean up bridge result
-    llama_bridge_free_result(&bridge_result);
+    llama_bridge_context *bridge_ctx = reinterpret_cast<llama_bridge_context *>(context_);
+    std::vector<llama_bridge_result> bridge_results(user_messages.size());
+    if (!llama_bridge_chat_batch(bridge_ctx, system_prompt.c_str(), messages.data(), static_cast<int>(messages.size()),
+                                 maxTokens, bridge_results.data()))
+    {
+        responses.assign(user_messages.size(), {.success = false, .error = "Invalid batch request"});
+        return responses;
+    }
 
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-    if (result.success && result.inferenceTimeMs == 0.0)
+    for (auto &bridge_result : bridge_results)
     {
-        result.inferenceTimeMs = static_cast<double>(duration.count());
+        responses.push_back(toResponse(bridge_result));
     }
+    return responses;
+}
 
-    return result;
+std::vector<std::string> LLMClient::splitIntoChunks(const std::vector<llama_token> &tokens, int chunkTokens)
+{
+    std::vector<std::string> chunks;
+    const size_t chunkSize = static_cast<size_t>(std::max(1, chunkTokens));
+
+    size_t begin = 0;
+    while (begin < tokens.size())
+    {
+        size_t end = std::min(tokens.size(), begin + chunkSize);
+
+        // Back up to the end of a sentence if there is one in the last quarter of the chunk
+        bool sentenceEnd = false;
+        if (end < tokens.size())
+        {
+            for (size_t i = end; i > begin + chunkSize * 3 / 4; i--)
+            {
+                const std::string piece = detokenize({tokens[i - 1]});
+                if (!piece.empty() && std::string(".?!\n").find(piece.back()) != std::string::npos)
+                {
+                    end = i;
+                    sentenceEnd = true;
+                    break;
+                }
+            }
+        }
+
+        std::string chunk = detokenize(std::vector<llama_token>(tokens.begin() + begin, tokens.begin() + end));
+
+        // Otherwise a byte-level token may end the slice inside a character; move the cut back until it does not
+        if (!sentenceEnd && end < tokens.size())
+        {
+            for (size_t cut = end - 1; !endsOnCodePoint(chunk) && cut > begin && end - cut < 4; cut--)
+            {
+                std::string shorter = detokenize(std::vector<llama_token>(tokens.begin() + begin, tokens.begin() + cut));
+                if (endsOnCodePoint(shorter))
+                {
+                    chunk.swap(shorter);
+                    end = cut;
+                }
+            }
+        }
+
+        chunks.push_back(chunk);
+        begin = end;
+    }
+    return chunks;
 }
 
 std::vector<llama_token> LLMClient::tokenize(const std::string &text)
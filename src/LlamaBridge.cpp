@@ -6,9 +6,33 @@
 #include <string>
 #include <memory>
 #include <cstring>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <chrono>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Prompt prefix decoded once; its KV cells are restored instead of prefilled again
+struct llama_bridge_prefix
+{
+    std::vector<llama_token> tokens;
+    std::vector<uint8_t> state; // llama_state_seq_get_data of sequence 0 holding exactly these tokens
+};
+
+// One KV cache sequence. Its tokens occupy positions 0..tokens.size()-1, so the size is also the
+// position the next token is decoded at.
+struct llama_bridge_sequence
+{
+    bool active = false;
+    std::vector<llama_token> tokens;
+};
 
 // Internal implementation struct (can use llama/ggml types here)
 struct llama_bridge_context
@@ -17,10 +41,19 @@ struct llama_bridge_context
     struct llama_context *ctx;
     struct llama_sampler *sampler;
     llama_bridge_params params;
+    struct llama_batch batch;                     // Reused for every decode, llama_n_batch tokens
+    std::vector<llama_bridge_sequence> sequences; // Indexed by llama_seq_id: 0 stateless, then sessions, then batch slots
+    int n_sessions;                               // Sequences 1..n_sessions are sessions
+    std::vector<llama_bridge_prefix> prefixes;    // Registered with llama_bridge_cache_prefix
+    llama_bridge_progress_callback progress;      // Prefill progress, may be null
+    void *progress_user_data;
 
-    llama_bridge_context() : model(nullptr), ctx(nullptr), sampler(nullptr) {}
+    llama_bridge_context() : model(nullptr), ctx(nullptr), sampler(nullptr), batch(), n_sessions(0), progress(nullptr), progress_user_data(nullptr) {}
 };
 
+// Sequence ids llama.cpp accepts in one context (LLAMA_MAX_SEQ in recent versions)
+static const int k_max_sequences = 64;
+
 // Helper function to allocate and copy string
 static char *allocate_string(const std::string &str)
 {
@@ -34,6 +67,30 @@ static char *allocate_string(const std::string &str)
     return result;
 }
 
+// Ask the kernel to start reading the whole file; llama's own mapping then finds the pages cached
+static void prefault_file(const char *path)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void *mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            madvise(mapping, static_cast<size_t>(st.st_size), MADV_WILLNEED);
+            munmap(mapping, static_cast<size_t>(st.st_size));
+        }
+    }
+    close(fd);
+#else
+    (void)path;
+#endif
+}
+
 llama_bridge_context *llama_bridge_init(llama_bridge_params params)
 {
     auto *bridge_ctx = new llama_bridge_context();
@@ -42,6 +99,11 @@ llama_bridge_context *llama_bridge_init(llama_bridge_params params)
     // Initialize llama backend
     llama_backend_init();
 
+    if (params.prefault && params.model_path)
+    {
+        prefault_file(params.model_path);
+    }
+
     // Load model
     llama_model_params model_params = llama_model_default_params();
     model_params.n_gpu_layers = 999; // Use CPU for compatibility
@@ -59,12 +121,26 @@ llama_bridge_context *llama_bridge_init(llama_bridge_params params)
     // Create context
     llama_context_params ctx_params = llama_context_default_params();
     ctx_params.n_ctx = params.context_size;
+    if (params.batch_size > 0)
+    {
+        ctx_params.n_batch = params.batch_size;
+    }
+    if (params.ubatch_size > 0)
+    {
+        ctx_params.n_ubatch = params.ubatch_size;
+    }
     // ctx_params.n_threads = params.threads;
     // ctx_params.n_threads_batch = params.threads;
     ctx_params.n_threads = std::min(params.threads, 8); // M1 optimization
     ctx_params.n_threads_batch = ctx_params.n_threads;
     ctx_params.flash_attn = true; // Enable flash attention if available
 
+    // Sequence 0, one per session and one per batch slot; the sequences share the whole context instead of splitting it
+    const int n_sessions = std::max(0, std::min(params.max_sessions, k_max_sequences - 1));
+    const int n_parallel = std::max(0, std::min(params.max_parallel, k_max_sequences - 1 - n_sessions));
+    ctx_params.n_seq_max = 1 + n_sessions + n_parallel;
+    ctx_params.kv_unified = true;
+
     bridge_ctx->ctx = llama_init_from_model(bridge_ctx->model, ctx_params);
     if (!bridge_ctx->ctx)
     {
@@ -74,6 +150,11 @@ llama_bridge_context *llama_bridge_init(llama_bridge_params params)
         return nullptr;
     }
 
+    bridge_ctx->batch = llama_batch_init(static_cast<int32_t>(llama_n_batch(bridge_ctx->ctx)), 0, 1);
+    bridge_ctx->sequences.resize(1 + n_sessions + n_parallel);
+    bridge_ctx->n_sessions = n_sessions;
+    bridge_ctx->sequences[0].active = true;
+
     // Initialize sampler chain
     auto sparams = llama_sampler_chain_default_params();
     bridge_ctx->sampler = llama_sampler_chain_init(sparams);
@@ -99,6 +180,36 @@ llama_bridge_context *llama_bridge_init(llama_bridge_params params)
     return bridge_ctx;
 }
 
+bool llama_bridge_warmup(llama_bridge_context *ctx)
+{
+    if (!ctx || !ctx->ctx || !ctx->model)
+        return false;
+
+    const struct llama_vocab *vocab = llama_model_get_vocab(ctx->model);
+    llama_token token = llama_vocab_bos(vocab);
+    if (token == LLAMA_TOKEN_NULL)
+    {
+        token = llama_vocab_eos(vocab);
+    }
+
+    struct llama_batch batch = llama_batch_get_one(&token, 1);
+    const bool ok = llama_decode(ctx->ctx, batch) == 0;
+
+    // Nothing of the warm-up may leak into the first prompt
+    llama_memory_clear(llama_get_memory(ctx->ctx), true);
+    for (auto &sequence : ctx->sequences)
+    {
+        sequence.tokens.clear();
+    }
+    if (ctx->sampler)
+    {
+        llama_sampler_reset(ctx->sampler);
+    }
+    llama_perf_context_reset(ctx->ctx);
+
+    return ok;
+}
+
 void llama_bridge_free(llama_bridge_context *ctx)
 {
     if (!ctx)
@@ -108,6 +219,10 @@ void llama_bridge_free(llama_bridge_context *ctx)
     {
         llama_sampler_free(ctx->sampler);
     }
+    if (ctx->batch.token)
+    {
+        llama_batch_free(ctx->batch);
+    }
     if (ctx->ctx)
     {
         llama_free(ctx->ctx);
@@ -120,59 +235,312 @@ void llama_bridge_free(llama_bridge_context *ctx)
     delete ctx;
 }
 
+static bool tokenize_prompt(llama_bridge_context *ctx, const char *text, bool add_special, std::vector<llama_token> &tokens)
+{
+    tokens.resize(strlen(text) + 32);
+    const struct llama_vocab *vocab = llama_model_get_vocab(ctx->model);
+    int n_tokens = llama_tokenize(vocab, text, strlen(text), tokens.data(), tokens.size(), add_special, false);
+    if (n_tokens < 0)
+    {
+        return false;
+    }
+    tokens.resize(n_tokens);
+    return true;
+}
+
+static size_t common_prefix_length(const std::vector<llama_token> &a, const std::vector<llama_token> &b)
+{
+    size_t n = 0;
+    while (n < a.size() && n < b.size() && a[n] == b[n])
+    {
+        n++;
+    }
+    return n;
+}
+
+// Append tokens to a sequence at the positions following its last token, one n_ubatch slice per
+// llama_decode (the size llama.cpp computes at anyway, and the granularity of progress reports).
+// Logits are requested for the last token only. On failure the sequence keeps what was decoded.
+static bool decode_tokens(llama_bridge_context *ctx, llama_seq_id seq, const llama_token *tokens, size_t count,
+                          bool report_progress)
+{
+    llama_bridge_sequence &sequence = ctx->sequences[seq];
+    const size_t n_slice = std::max<size_t>(1, std::min(llama_n_ubatch(ctx->ctx), llama_n_batch(ctx->ctx)));
+    const int total = static_cast<int>(sequence.tokens.size() + count);
+    report_progress = report_progress && ctx->progress;
+
+    if (report_progress)
+    {
+        ctx->progress(static_cast<int>(sequence.tokens.size()), total, ctx->progress_user_data);
+    }
+
+    for (size_t offset = 0; offset < count; offset += n_slice)
+    {
+        const size_t n = std::min(n_slice, count - offset);
+        for (size_t i = 0; i < n; i++)
+        {
+            ctx->batch.token[i] = tokens[offset + i];
+            ctx->batch.pos[i] = static_cast<llama_pos>(sequence.tokens.size() + i);
+            ctx->batch.n_seq_id[i] = 1;
+            ctx->batch.seq_id[i][0] = seq;
+            ctx->batch.logits[i] = offset + i == count - 1;
+        }
+        ctx->batch.n_tokens = static_cast<int32_t>(n);
+
+        if (llama_decode(ctx->ctx, ctx->batch) != 0)
+        {
+            // Drop whatever a failed decode may have left behind so cells and positions stay in step
+            llama_memory_seq_rm(llama_get_memory(ctx->ctx), seq, static_cast<llama_pos>(sequence.tokens.size()), -1);
+            return false;
+        }
+        sequence.tokens.insert(sequence.tokens.end(), tokens + offset, tokens + offset + n);
+
+        if (report_progress)
+        {
+            ctx->progress(static_cast<int>(sequence.tokens.size()), total, ctx->progress_user_data);
+        }
+    }
+    return true;
+}
+
+// Keep the longest reusable start of tokens in the sequence (what is already in it, or a registered
+// prefix) and drop everything after it. Returns the number of tokens kept; at least one is left to decode.
+static size_t keep_cached_start(llama_bridge_context *ctx, llama_seq_id seq, const std::vector<llama_token> &tokens)
+{
+    llama_memory_t mem = llama_get_memory(ctx->ctx);
+    llama_bridge_sequence &sequence = ctx->sequences[seq];
+
+    size_t n_keep = common_prefix_length(sequence.tokens, tokens);
+    const llama_bridge_prefix *restore = nullptr;
+    for (const auto &prefix : ctx->prefixes)
+    {
+        if (prefix.tokens.size() > n_keep && common_prefix_length(prefix.tokens, tokens) == prefix.tokens.size())
+        {
+            n_keep = prefix.tokens.size();
+            restore = &prefix;
+        }
+    }
+
+    // At least one token is decoded so there are logits to sample from
+    if (n_keep >= tokens.size())
+    {
+        n_keep = tokens.size() - 1;
+    }
+
+    if (restore)
+    {
+        llama_memory_seq_rm(mem, seq, -1, -1);
+        sequence.tokens.clear();
+        if (llama_state_seq_set_data(ctx->ctx, restore->state.data(), restore->state.size(), seq) == 0)
+        {
+            n_keep = 0; // Unusable snapshot: prefill everything
+        }
+        else
+        {
+            sequence.tokens = restore->tokens;
+        }
+    }
+
+    if (!llama_memory_seq_rm(mem, seq, static_cast<llama_pos>(n_keep), -1))
+    {
+        // Partial removal unsupported (recurrent memory): start from scratch
+        llama_memory_seq_rm(mem, seq, -1, -1);
+        n_keep = 0;
+    }
+    sequence.tokens.resize(std::min(sequence.tokens.size(), n_keep));
+    return n_keep;
+}
+
+// Make the sequence hold exactly tokens: keep the longest reusable start and prefill the rest.
+// Logits are requested for the last token.
+static bool prefill(llama_bridge_context *ctx, llama_seq_id seq, const std::vector<llama_token> &tokens, int *n_cached)
+{
+    const size_t n_keep = keep_cached_start(ctx, seq, tokens);
+    if (!decode_tokens(ctx, seq, tokens.data() + n_keep, tokens.size() - n_keep, true))
+    {
+        return false;
+    }
+
+    if (n_cached)
+    {
+        *n_cached = static_cast<int>(n_keep);
+    }
+    return true;
+}
+
+bool llama_bridge_cache_prefix(llama_bridge_context *ctx, const char *prefix)
+{
+    if (!ctx || !ctx->ctx || !ctx->model || !prefix)
+        return false;
+
+    std::vector<llama_token> tokens;
+    if (!tokenize_prompt(ctx, prefix, true, tokens) || tokens.empty())
+        return false;
+
+    // The last token may merge with whatever follows in a full prompt; leave it to the suffix
+    tokens.pop_back();
+    if (tokens.empty())
+        return false;
+
+    for (const auto &existing : ctx->prefixes)
+    {
+        if (existing.tokens == tokens)
+            return true;
+    }
+
+    // Decode the prefix alone into sequence 0 and snapshot it
+    llama_memory_seq_rm(llama_get_memory(ctx->ctx), 0, -1, -1);
+    ctx->sequences[0].tokens.clear();
+    if (!decode_tokens(ctx, 0, tokens.data(), tokens.size(), false))
+    {
+        return false;
+    }
+
+    llama_bridge_prefix entry;
+    entry.tokens = tokens;
+    entry.state.resize(llama_state_seq_get_size(ctx->ctx, 0));
+    if (entry.state.empty() ||
+        llama_state_seq_get_data(ctx->ctx, entry.state.data(), entry.state.size(), 0) != entry.state.size())
+    {
+        return false;
+    }
+
+    ctx->prefixes.push_back(std::move(entry));
+    return true;
+}
+
+// Qwen2.5 chat format up to the end of the user message
+static std::string chat_prompt_head(const char *system_prompt, const char *user_message)
+{
+    if (system_prompt && strlen(system_prompt) > 0)
+    {
+        return std::string("<|im_start|>system\n") + system_prompt +
+               "<|im_end|>\n<|im_start|>user\n" + user_message;
+    }
+    return std::string("<|im_start|>user\n") + user_message;
+}
+
+bool llama_bridge_cache_chat_prefix(llama_bridge_context *ctx, const char *system_prompt, const char *user_prefix)
+{
+    return llama_bridge_cache_prefix(ctx, chat_prompt_head(system_prompt, user_prefix ? user_prefix : "").c_str());
+}
+
+// Stop sequences of the Qwen chat format; generated text is cut at the first of them
+static const char *const k_stop_sequences[] = {"<|im_end|>", "<|endoftext|>"};
+
+// End of the text that can be streamed: a tail that may still grow into a stop sequence,
+// or an incomplete UTF-8 character, is held back until the next piece
+static size_t streamable_length(const std::string &text)
+{
+    size_t end = text.size();
+
+    for (const char *stop : k_stop_sequences)
+    {
+        const size_t stop_len = strlen(stop);
+        for (size_t n = std::min(stop_len - 1, text.size()); n > 0; n--)
+        {
+            if (text.compare(text.size() - n, n, stop, n) == 0)
+            {
+                end = std::min(end, text.size() - n);
+                break;
+            }
+        }
+    }
+
+    // Back up to the lead byte of the last character and keep it only when complete
+    size_t lead = end;
+    while (lead > 0 && end - lead < 3 && (static_cast<unsigned char>(text[lead - 1]) & 0xC0) == 0x80)
+    {
+        lead--;
+    }
+    if (lead > 0)
+    {
+        const unsigned char c = static_cast<unsigned char>(text[lead - 1]);
+        const size_t need = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+        if (end - (lead - 1) < need)
+        {
+            end = lead - 1;
+        }
+    }
+
+    return end;
+}
+
 llama_bridge_result llama_bridge_generate(
     llama_bridge_context *ctx,
     const char *prompt,
     int max_tokens)
 {
+    return llama_bridge_generate_stream(ctx, prompt, max_tokens, nullptr, nullptr);
+}
 
+// Generate after prompt in sequence seq. With replace the prompt is the whole new content of the
+// sequence (reusing whatever start of it is cached); otherwise it is appended to the sequence.
+static llama_bridge_result generate_in_sequence(
+    llama_bridge_context *ctx,
+    llama_seq_id seq,
+    const char *prompt,
+    bool replace,
+    int max_tokens,
+    llama_bridge_token_callback callback,
+    void *user_data)
+{
     llama_bridge_result result = {};
     auto start = std::chrono::high_resolution_clock::now();
 
-    if (!ctx || !ctx->ctx || !ctx->model || !prompt)
+    if (max_tokens <= 0)
+    {
+        max_tokens = ctx->params.max_tokens;
+    }
+
+    // Tokenize the prompt; special tokens (BOS) only at the start of a sequence
+    const std::vector<llama_token> &resident = ctx->sequences[seq].tokens;
+    std::vector<llama_token> prompt_tokens;
+    if (!tokenize_prompt(ctx, prompt, replace || resident.empty(), prompt_tokens))
     {
         result.success = false;
-        result.error_msg = allocate_string("Invalid parameters");
+        result.error_msg = allocate_string("Failed to tokenize prompt");
         return result;
     }
 
-    if (max_tokens <= 0)
+    std::vector<llama_token> tokens;
+    if (!replace)
     {
-        max_tokens = ctx->params.max_tokens;
+        tokens = resident;
     }
-
-    // Tokenize the prompt
-    std::vector<llama_token> tokens(strlen(prompt) + 32);
-    const struct llama_vocab *vocab = llama_model_get_vocab(ctx->model);
-    int n_tokens = llama_tokenize(vocab, prompt, strlen(prompt), tokens.data(), tokens.size(), true, false);
-
-    if (n_tokens < 0)
+    tokens.insert(tokens.end(), prompt_tokens.begin(), prompt_tokens.end());
+    if (tokens.empty())
     {
         result.success = false;
         result.error_msg = allocate_string("Failed to tokenize prompt");
         return result;
     }
-    tokens.resize(n_tokens);
 
-    // Clear the KV cache
-    // llama_memory_clear(llama_get_memory(ctx->ctx), true);
-
-    // Evaluate the prompt tokens
-    struct llama_batch batch = llama_batch_get_one(tokens.data(), tokens.size());
-    // Request logits for the last token in the prompt evaluation
-    if (batch.n_tokens > 0 && batch.logits)
+    // Evaluate the prompt tokens that are not in the KV cache already
+    int n_cached = 0;
+    if (!prefill(ctx, seq, tokens, &n_cached))
     {
-        batch.logits[batch.n_tokens - 1] = 1;
+        result.success = false;
+        result.error_msg = allocate_string("Failed to evaluate prompt");
+        return result;
     }
+    result.prompt_tokens = static_cast<int>(tokens.size());
+    result.prompt_tokens_cached = n_cached;
 
-    // Also refer to the examples on how others have implemented it.
-    if (llama_decode(ctx->ctx, batch) != 0)
+    // Every generated token takes a cell of the shared context; stop when it is full instead of failing mid-answer
+    size_t resident_total = 0;
+    for (const auto &sequence : ctx->sequences)
+    {
+        resident_total += sequence.tokens.size();
+    }
+    const size_t n_ctx = llama_n_ctx(ctx->ctx);
+    max_tokens = static_cast<int>(std::min(static_cast<size_t>(max_tokens), n_ctx - std::min(n_ctx, resident_total)));
+    if (max_tokens <= 0)
     {
         result.success = false;
-        result.error_msg = allocate_string("Failed to evaluate prompt");
+        result.error_msg = allocate_string("No room left in the context");
         return result;
     }
-    int n_pos = tokens.size();
 
     // Reset sampler state and accept prompt tokens so penalties work properly
     if (ctx->sampler)
@@ -186,12 +554,20 @@ llama_bridge_result llama_bridge_generate(
 
     // Generate tokens
     std::string generated_text;
+    size_t emitted = 0; // Bytes of generated_text already passed to the callback
+    bool cancelled = false;
     int tokens_generated = 0;
 
     for (int i = 0; i < max_tokens; ++i)
     {
         // Use convenience API which applies chain and accepts the sampled token
         llama_token next_token = llama_sampler_sample(ctx->sampler, ctx->ctx, -1);
+        if (i == 0)
+        {
+            result.time_to_first_token_ms = std::chrono::duration<double, std::milli>(
+                                                std::chrono::high_resolution_clock::now() - start)
+                                                .count();
+        }
 
         // Check for end of text
         const struct llama_vocab *vocab = llama_model_get_vocab(ctx->model);
@@ -234,22 +610,34 @@ llama_bridge_result llama_bridge_generate(
             break;
         }
 
-        // Print the string as and when it's generated
-        // std::cout << token_str << " ";
-
-        // Evaluate the new token and request logits for it
-        struct llama_batch next_batch = llama_batch_get_one(&next_token, 1);
-        if (next_batch.n_tokens > 0 && next_batch.logits)
+        // Pass the text on as soon as it can no longer turn out to be part of a stop sequence
+        if (callback)
         {
-            next_batch.logits[next_batch.n_tokens - 1] = 1;
+            const size_t ready = streamable_length(generated_text);
+            if (ready > emitted)
+            {
+                cancelled = !callback(generated_text.data() + emitted, static_cast<int>(ready - emitted), user_data);
+                emitted = ready;
+                if (cancelled)
+                {
+                    break;
+                }
+            }
         }
-        if (llama_decode(ctx->ctx, next_batch) != 0)
+
+        // Evaluate the new token at the next position of the sequence and request logits for it
+        if (!decode_tokens(ctx, seq, &next_token, 1, false))
         {
             result.success = false;
             result.error_msg = allocate_string("Failed to evaluate generated token");
             return result;
         }
-        n_pos++;
+    }
+
+    // Whatever was held back (the stop sequence itself has been cut off by now)
+    if (callback && !cancelled && generated_text.size() > emitted)
+    {
+        callback(generated_text.data() + emitted, static_cast<int>(generated_text.size() - emitted), user_data);
     }
 
     auto end = std::chrono::high_resolution_clock::now();
@@ -263,28 +651,468 @@ llama_bridge_result llama_bridge_generate(
     return result;
 }
 
+llama_bridge_result llama_bridge_generate_stream(
+    llama_bridge_context *ctx,
+    const char *prompt,
+    int max_tokens,
+    llama_bridge_token_callback callback,
+    void *user_data)
+{
+    if (!ctx || !ctx->ctx || !ctx->model || !prompt)
+    {
+        llama_bridge_result result = {};
+        result.success = false;
+        result.error_msg = allocate_string("Invalid parameters");
+        return result;
+    }
+
+    return generate_in_sequence(ctx, 0, prompt, true, max_tokens, callback, user_data);
+}
+
 llama_bridge_result llama_bridge_chat(
     llama_bridge_context *ctx,
     const char *system_prompt,
     const char *user_message,
     int max_tokens)
 {
+    return llama_bridge_chat_stream(ctx, system_prompt, user_message, max_tokens, nullptr, nullptr);
+}
+
+llama_bridge_result llama_bridge_chat_stream(
+    llama_bridge_context *ctx,
+    const char *system_prompt,
+    const char *user_message,
+    int max_tokens,
+    llama_bridge_token_callback callback,
+    void *user_data)
+{
 
     // Construct a chat-formatted prompt using Qwen2.5 format
-    std::string full_prompt;
-    if (system_prompt && strlen(system_prompt) > 0)
+    const std::string full_prompt = chat_prompt_head(system_prompt, user_message) +
+                                    "<|im_end|>\n<|im_start|>assistant\n";
+
+    return llama_bridge_generate_stream(ctx, full_prompt.c_str(), max_tokens, callback, user_data);
+}
+
+static bool valid_session(llama_bridge_context *ctx, llama_bridge_session session)
+{
+    return ctx && ctx->ctx && session > 0 && session <= ctx->n_sessions &&
+           ctx->sequences[session].active;
+}
+
+llama_bridge_session llama_bridge_session_create(llama_bridge_context *ctx)
+{
+    if (!ctx || !ctx->ctx)
+        return -1;
+
+    for (int seq = 1; seq <= ctx->n_sessions; seq++)
+    {
+        llama_bridge_sequence &sequence = ctx->sequences[seq];
+        if (!sequence.active)
+        {
+            // A freed id may still own cells if an earlier removal failed
+            llama_memory_seq_rm(llama_get_memory(ctx->ctx), static_cast<llama_seq_id>(seq), -1, -1);
+            sequence.active = true;
+            sequence.tokens.clear();
+            return static_cast<llama_bridge_session>(seq);
+        }
+    }
+    return -1;
+}
+
+bool llama_bridge_session_reset(llama_bridge_context *ctx, llama_bridge_session session)
+{
+    if (!valid_session(ctx, session))
+        return false;
+
+    llama_memory_seq_rm(llama_get_memory(ctx->ctx), session, -1, -1);
+    ctx->sequences[session].tokens.clear();
+    return true;
+}
+
+llama_bridge_session llama_bridge_session_fork(llama_bridge_context *ctx, llama_bridge_session session)
+{
+    if (!valid_session(ctx, session))
+        return -1;
+
+    llama_bridge_session fork = llama_bridge_session_create(ctx);
+    if (fork < 0)
+        return -1;
+
+    // The fork shares the cells of the original; only what either appends later is its own
+    llama_memory_seq_cp(llama_get_memory(ctx->ctx), session, fork, -1, -1);
+    ctx->sequences[fork].tokens = ctx->sequences[session].tokens;
+    return fork;
+}
+
+void llama_bridge_session_destroy(llama_bridge_context *ctx, llama_bridge_session session)
+{
+    if (!valid_session(ctx, session))
+        return;
+
+    llama_memory_seq_rm(llama_get_memory(ctx->ctx), session, -1, -1);
+    ctx->sequences[session].tokens.clear();
+    ctx->sequences[session].active = false;
+}
+
+int llama_bridge_session_position(llama_bridge_context *ctx, llama_bridge_session session)
+{
+    if (!valid_session(ctx, session))
+        return -1;
+    return static_cast<int>(ctx->sequences[session].tokens.size());
+}
+
+llama_bridge_result llama_bridge_session_generate(
+    llama_bridge_context *ctx,
+    llama_bridge_session session,
+    const char *prompt,
+    int max_tokens,
+    llama_bridge_token_callback callback,
+    void *user_data)
+{
+    if (!valid_session(ctx, session) || !ctx->model || !prompt)
+    {
+        llama_bridge_result result = {};
+        result.success = false;
+        result.error_msg = allocate_string("Invalid parameters");
+        return result;
+    }
+
+    return generate_in_sequence(ctx, session, prompt, false, max_tokens, callback, user_data);
+}
+
+llama_bridge_result llama_bridge_session_chat(
+    llama_bridge_context *ctx,
+    llama_bridge_session session,
+    const char *system_prompt,
+    const char *user_message,
+    int max_tokens,
+    llama_bridge_token_callback callback,
+    void *user_data)
+{
+    if (!valid_session(ctx, session) || !user_message)
+    {
+        llama_bridge_result result = {};
+        result.success = false;
+        result.error_msg = allocate_string("Invalid parameters");
+        return result;
+    }
+
+    // The first turn opens the conversation; later ones close the previous answer (its end token
+    // was sampled but never decoded) and add the next user message
+    std::string turn;
+    if (ctx->sequences[session].tokens.empty())
     {
-        full_prompt = std::string("<|im_start|>system\n") + system_prompt +
-                      "<|im_end|>\n<|im_start|>user\n" + user_message +
-                      "<|im_end|>\n<|im_start|>assistant\n";
+        turn = chat_prompt_head(system_prompt, user_message);
     }
     else
     {
-        full_prompt = std::string("<|im_start|>user\n") + user_message +
-                      "<|im_end|>\n<|im_start|>assistant\n";
+        turn = std::string("<|im_end|>\n<|im_start|>user\n") + user_message;
     }
+    turn += "<|im_end|>\n<|im_start|>assistant\n";
 
-    return llama_bridge_generate(ctx, full_prompt.c_str(), max_tokens);
+    return llama_bridge_session_generate(ctx, session, turn.c_str(), max_tokens, callback, user_data);
+}
+
+// Cut text at the first stop sequence; true if it had one
+static bool cut_at_stop_sequence(std::string &text)
+{
+    for (const char *stop : k_stop_sequences)
+    {
+        const size_t stop_pos = text.find(stop);
+        if (stop_pos != std::string::npos)
+        {
+            text.resize(stop_pos);
+            return true;
+        }
+    }
+    return false;
+}
+
+// A sequence of a batched call and the prompt it is working on
+struct llama_bridge_slot
+{
+    llama_seq_id seq = 0;
+    struct llama_sampler *sampler = nullptr; // Own clone of the chain, so sampler state is per prompt
+    int request = -1;                        // Index of the prompt, -1 when the slot is free
+    std::vector<llama_token> prompt;
+    size_t n_prompt_done = 0;                // Prompt tokens in the KV cache
+    size_t kv_charge = 0;                    // Cells reserved: prompt plus max_tokens
+    llama_token pending = LLAMA_TOKEN_NULL;  // Sampled token still to be decoded
+    int32_t i_batch = -1;                    // Index of the slot's logits in the current batch
+    int n_generated = 0;
+    std::string text;
+};
+
+static bool generate_batch(llama_bridge_context *ctx, const std::vector<std::string> &prompts, int max_tokens,
+                           llama_bridge_result *results)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    auto elapsed_ms = [&start]()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+
+    if (max_tokens <= 0)
+    {
+        max_tokens = ctx->params.max_tokens;
+    }
+
+    llama_memory_t mem = llama_get_memory(ctx->ctx);
+    const struct llama_vocab *vocab = llama_model_get_vocab(ctx->model);
+    const int n_slice = static_cast<int>(std::max<uint32_t>(1, std::min(llama_n_ubatch(ctx->ctx), llama_n_batch(ctx->ctx))));
+
+    // Tokenize everything up front: admission needs the sizes, progress the total
+    std::vector<std::vector<llama_token>> tokenized(prompts.size());
+    int prompt_total = 0;
+    for (size_t i = 0; i < prompts.size(); i++)
+    {
+        results[i] = {};
+        if (!tokenize_prompt(ctx, prompts[i].c_str(), true, tokenized[i]) || tokenized[i].empty())
+        {
+            results[i].success = false;
+            results[i].error_msg = allocate_string("Failed to tokenize prompt");
+            tokenized[i].clear();
+            continue;
+        }
+        prompt_total += static_cast<int>(tokenized[i].size());
+    }
+
+    // Sequence 0 and the dedicated batch sequences serve as slots; open sessions keep their cells
+    size_t kv_budget = llama_n_ctx(ctx->ctx);
+    std::vector<llama_bridge_slot> slots;
+    for (size_t seq = 0; seq < ctx->sequences.size(); seq++)
+    {
+        llama_bridge_sequence &sequence = ctx->sequences[seq];
+        if (seq > 0 && static_cast<int>(seq) <= ctx->n_sessions)
+        {
+            if (sequence.active)
+            {
+                kv_budget -= std::min(kv_budget, sequence.tokens.size());
+            }
+            continue;
+        }
+        llama_memory_seq_rm(mem, static_cast<llama_seq_id>(seq), -1, -1);
+        sequence.tokens.clear();
+
+        llama_bridge_slot slot;
+        slot.seq = static_cast<llama_seq_id>(seq);
+        slot.sampler = llama_sampler_clone(ctx->sampler);
+        slots.push_back(std::move(slot));
+    }
+
+    size_t next = 0;
+    size_t kv_used = 0;
+    int n_live = 0;
+    int prompt_done = 0;
+
+    auto release = [&](llama_bridge_slot &slot)
+    {
+        llama_memory_seq_rm(mem, slot.seq, -1, -1);
+        ctx->sequences[slot.seq].tokens.clear();
+        kv_used -= slot.kv_charge;
+        n_live--;
+        slot.request = -1;
+    };
+
+    auto finish = [&](llama_bridge_slot &slot)
+    {
+        llama_bridge_result &result = results[slot.request];
+        result.success = true;
+        result.text = allocate_string(slot.text);
+        result.tokens_generated = slot.n_generated;
+        result.inference_time_ms = elapsed_ms();
+        release(slot);
+    };
+
+    auto add_to_batch = [&](llama_bridge_slot &slot, llama_token token, bool logits)
+    {
+        llama_bridge_sequence &sequence = ctx->sequences[slot.seq];
+        const int32_t i = ctx->batch.n_tokens++;
+        ctx->batch.token[i] = token;
+        ctx->batch.pos[i] = static_cast<llama_pos>(sequence.tokens.size());
+        ctx->batch.n_seq_id[i] = 1;
+        ctx->batch.seq_id[i][0] = slot.seq;
+        ctx->batch.logits[i] = logits;
+        sequence.tokens.push_back(token);
+        if (logits)
+        {
+            slot.i_batch = i;
+        }
+    };
+
+    if (ctx->progress)
+    {
+        ctx->progress(0, prompt_total, ctx->progress_user_data);
+    }
+
+    while (true)
+    {
+        // Admit waiting prompts into free slots while their cells fit (one always runs)
+        for (auto &slot : slots)
+        {
+            if (slot.request >= 0)
+                continue;
+            while (next < prompts.size() && tokenized[next].empty())
+            {
+                next++;
+            }
+            if (next >= prompts.size())
+                break;
+
+            const size_t charge = tokenized[next].size() + static_cast<size_t>(max_tokens);
+            if (n_live > 0 && kv_used + charge > kv_budget)
+                break;
+
+            slot.request = static_cast<int>(next++);
+            slot.prompt = std::move(tokenized[slot.request]);
+            slot.n_prompt_done = keep_cached_start(ctx, slot.seq, slot.prompt);
+            slot.kv_charge = charge;
+            slot.pending = LLAMA_TOKEN_NULL;
+            slot.i_batch = -1;
+            slot.n_generated = 0;
+            slot.text.clear();
+            kv_used += charge;
+            n_live++;
+
+            results[slot.request].prompt_tokens = static_cast<int>(slot.prompt.size());
+            results[slot.request].prompt_tokens_cached = static_cast<int>(slot.n_prompt_done);
+            prompt_done += static_cast<int>(slot.n_prompt_done);
+
+            llama_sampler_reset(slot.sampler);
+            for (auto t : slot.prompt)
+            {
+                llama_sampler_accept(slot.sampler, t);
+            }
+        }
+
+        if (n_live == 0)
+            break;
+
+        // One decode for all slots: the next token of every generating slot, then prompt slices
+        ctx->batch.n_tokens = 0;
+        for (auto &slot : slots)
+        {
+            if (slot.request >= 0 && slot.pending != LLAMA_TOKEN_NULL && ctx->batch.n_tokens < n_slice)
+            {
+                add_to_batch(slot, slot.pending, true);
+                slot.pending = LLAMA_TOKEN_NULL;
+            }
+        }
+        int prompt_in_batch = 0;
+        for (auto &slot : slots)
+        {
+            while (slot.request >= 0 && slot.n_prompt_done < slot.prompt.size() && ctx->batch.n_tokens < n_slice)
+            {
+                const bool last = ++slot.n_prompt_done == slot.prompt.size();
+                add_to_batch(slot, slot.prompt[slot.n_prompt_done - 1], last);
+                prompt_in_batch++;
+            }
+        }
+
+        if (llama_decode(ctx->ctx, ctx->batch) != 0)
+        {
+            // Out of cells or a backend error: the prompts in flight fail, the waiting ones still run
+            for (auto &slot : slots)
+            {
+                if (slot.request >= 0)
+                {
+                    results[slot.request].success = false;
+                    results[slot.request].error_msg = allocate_string("Failed to evaluate batch");
+                    release(slot);
+                }
+            }
+            continue;
+        }
+
+        if (prompt_in_batch > 0 && ctx->progress)
+        {
+            prompt_done += prompt_in_batch;
+            ctx->progress(prompt_done, prompt_total, ctx->progress_user_data);
+        }
+
+        for (auto &slot : slots)
+        {
+            if (slot.request < 0 || slot.i_batch < 0)
+                continue;
+
+            const llama_token token = llama_sampler_sample(slot.sampler, ctx->ctx, slot.i_batch);
+            slot.i_batch = -1;
+            if (slot.n_generated == 0 && slot.text.empty())
+            {
+                results[slot.request].time_to_first_token_ms = elapsed_ms();
+            }
+
+            if (llama_vocab_is_eog(vocab, token))
+            {
+                finish(slot);
+                continue;
+            }
+
+            char token_str[256];
+            const int n = llama_token_to_piece(vocab, token, token_str, sizeof(token_str), 0, false);
+            if (n < 0)
+            {
+                results[slot.request].success = false;
+                results[slot.request].error_msg = allocate_string("Failed to convert token to text");
+                release(slot);
+                continue;
+            }
+            slot.text.append(token_str, n);
+            slot.n_generated++;
+
+            if (cut_at_stop_sequence(slot.text) || slot.n_generated >= max_tokens)
+            {
+                finish(slot);
+                continue;
+            }
+            slot.pending = token;
+        }
+    }
+
+    for (auto &slot : slots)
+    {
+        llama_sampler_free(slot.sampler);
+    }
+    return true;
+}
+
+bool llama_bridge_generate_batch(
+    llama_bridge_context *ctx,
+    const char *const *prompts,
+    int count,
+    int max_tokens,
+    llama_bridge_result *results)
+{
+    if (!ctx || !ctx->ctx || !ctx->model || !prompts || count < 0 || (count > 0 && !results))
+        return false;
+
+    std::vector<std::string> texts;
+    for (int i = 0; i < count; i++)
+    {
+        texts.push_back(prompts[i] ? prompts[i] : "");
+    }
+    return generate_batch(ctx, texts, max_tokens, results);
+}
+
+bool llama_bridge_chat_batch(
+    llama_bridge_context *ctx,
+    const char *system_prompt,
+    const char *const *user_messages,
+    int count,
+    int max_tokens,
+    llama_bridge_result *results)
+{
+    if (!ctx || !ctx->ctx || !ctx->model || !user_messages || count < 0 || (count > 0 && !results))
+        return false;
+
+    std::vector<std::string> texts;
+    for (int i = 0; i < count; i++)
+    {
+        texts.push_back(chat_prompt_head(system_prompt, user_messages[i] ? user_messages[i] : "") +
+                        "<|im_end|>\n<|im_start|>assistant\n");
+    }
+    return generate_batch(ctx, texts, max_tokens, results);
 }
 
 void llama_bridge_free_result(llama_bridge_result *result)
@@ -368,6 +1196,14 @@ void llama_bridge_free_tokens(llama_bridge_tokens *tokens)
     tokens->count = 0;
 }
 
+void llama_bridge_set_progress_callback(llama_bridge_context *ctx, llama_bridge_progress_callback callback, void *user_data)
+{
+    if (!ctx)
+        return;
+    ctx->progress = callback;
+    ctx->progress_user_data = user_data;
+}
+
 int llama_bridge_get_context_size(llama_bridge_context *ctx)
 {
     if (!ctx || !ctx->ctx)
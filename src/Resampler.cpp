@@ -0,0 +1,361 @@
+#include "Resampler.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#define RESAMPLER_X86 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RESAMPLER_NEON 1
+#endif
+
+namespace
+{
+    // ------------------------------------------------------------------
+    // Compile-time filter design
+    // ------------------------------------------------------------------
+
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double PASSBAND = 0.9375;   ///< Cutoff as a fraction of the lower Nyquist (7.5 kHz at 16 kHz)
+    constexpr double TRANSITION = 0.0625; ///< Transition width as a fraction of the lower rate (1 kHz at 16 kHz)
+
+    constexpr double constSin(double x)
+    {
+        // Reduce to [-pi, pi], then Taylor series
+        x -= 2.0 * PI * static_cast<double>(static_cast<long long>(x / (2.0 * PI)));
+        if (x > PI)
+        {
+            x -= 2.0 * PI;
+        }
+        else if (x < -PI)
+        {
+            x += 2.0 * PI;
+        }
+        double term = x;
+        double sum = x;
+        for (int n = 1; n < 14; n++)
+        {
+            term *= -x * x / static_cast<double>((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double constCos(double x)
+    {
+        return constSin(x + 0.5 * PI);
+    }
+
+    /**
+     * @brief Unit phasor advanced by a fixed angle per step
+     *
+     * Keeps compile-time evaluation cheap: one rotation per tap instead of a
+     * series expansion per tap.
+     */
+    struct Rotor
+    {
+        double s;
+        double c;
+        double stepSin;
+        double stepCos;
+
+        constexpr Rotor(double start, double step)
+            : s(constSin(start)), c(constCos(start)), stepSin(constSin(step)), stepCos(constCos(step))
+        {
+        }
+
+        constexpr void advance()
+        {
+            const double nextS = s * stepCos + c * stepSin;
+            c = c * stepCos - s * stepSin;
+            s = nextS;
+        }
+    };
+
+    /// Taps per polyphase branch: a 4-term Blackman-Harris main lobe spans ~4/N, rounded up to a multiple of 8
+    constexpr size_t tapsFor(unsigned int up, unsigned int down)
+    {
+        const double ratio = down > up ? static_cast<double>(down) / up : 1.0;
+        const double taps = 4.0 / TRANSITION * ratio;
+        return (static_cast<size_t>(taps) + 8) & ~static_cast<size_t>(7);
+    }
+
+    /**
+     * @brief Build the polyphase bank for an L/M rate change
+     *
+     * The prototype is a Blackman-Harris windowed sinc (~90 dB stopband). Branch p
+     * holds h[p + L*j] for j = 0..T-1 in reverse order, so each output is a forward
+     * dot product with the T most recent input samples. Every branch is normalized
+     * to unit DC gain.
+     */
+    template <unsigned int L, unsigned int M>
+    constexpr std::array<float, L * tapsFor(L, M)> makeBank()
+    {
+        constexpr size_t T = tapsFor(L, M);
+        constexpr size_t N = L * T;
+        const double cutoff = 0.5 * PASSBAND / (L > M ? L : M); // cycles/sample at the upsampled rate
+        const double center = 0.5 * static_cast<double>(N - 1);
+
+        Rotor sinc(-2.0 * PI * cutoff * center, 2.0 * PI * cutoff);
+        Rotor window(0.0, 2.0 * PI / static_cast<double>(N - 1));
+
+        std::array<double, N> prototype{};
+        for (size_t k = 0; k < N; k++)
+        {
+            const double t = static_cast<double>(k) - center;
+            const double x = PI * 2.0 * cutoff * t;
+            const double c1 = window.c;
+            const double c2 = 2.0 * c1 * c1 - 1.0;
+            const double c3 = 2.0 * c1 * c2 - c1;
+            const double w = 0.35875 - 0.48829 * c1 + 0.14128 * c2 - 0.01168 * c3;
+            prototype[k] = (x == 0.0 ? 1.0 : sinc.s / x) * w;
+
+            sinc.advance();
+            window.advance();
+        }
+
+        std::array<float, N> bank{};
+        for (size_t p = 0; p < L; p++)
+        {
+            double gain = 0.0;
+            for (size_t j = 0; j < T; j++)
+            {
+                gain += prototype[p + L * j];
+            }
+            for (size_t j = 0; j < T; j++)
+            {
+                bank[p * T + (T - 1 - j)] = static_cast<float>(prototype[p + L * j] / gain);
+            }
+        }
+        return bank;
+    }
+
+    template <unsigned int L, unsigned int M>
+    constexpr auto BANK = makeBank<L, M>();
+
+    struct BankInfo
+    {
+        unsigned int inputRate;
+        unsigned int outputRate;
+        unsigned int up;
+        unsigned int down;
+        size_t taps;
+        const float *coefficients;
+    };
+
+#define RESAMPLER_BANK(IN, OUT, L, M) \
+    BankInfo { IN, OUT, L, M, tapsFor(L, M), BANK<L, M>.data() }
+
+    constexpr BankInfo BANKS[] = {
+        RESAMPLER_BANK(8000, 16000, 2, 1),
+        RESAMPLER_BANK(22050, 16000, 320, 441),
+        RESAMPLER_BANK(24000, 16000, 2, 3),
+        RESAMPLER_BANK(32000, 16000, 1, 2),
+        RESAMPLER_BANK(44100, 16000, 160, 441),
+        RESAMPLER_BANK(48000, 16000, 1, 3),
+        RESAMPLER_BANK(96000, 16000, 1, 6),
+    };
+
+#undef RESAMPLER_BANK
+
+    const BankInfo *findBank(unsigned int inputRate, unsigned int outputRate)
+    {
+        for (const auto &bank : BANKS)
+        {
+            if (bank.inputRate == inputRate && bank.outputRate == outputRate)
+            {
+                return &bank;
+            }
+        }
+        return nullptr;
+    }
+
+    // ------------------------------------------------------------------
+    // Dot product kernels
+    // ------------------------------------------------------------------
+
+    using DotKernel = float (*)(const float *a, const float *b, size_t n);
+
+    float dotScalar(const float *a, const float *b, size_t n)
+    {
+        float sum = 0.0f;
+        for (size_t i = 0; i < n; i++)
+        {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+#if defined(RESAMPLER_X86)
+    float dotSse2(const float *a, const float *b, size_t n)
+    {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        }
+        __m128 acc = _mm_add_ps(acc0, acc1);
+        acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+        acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+        return _mm_cvtss_f32(acc) + dotScalar(a + i, b + i, n - i);
+    }
+
+    __attribute__((target("avx2,fma"))) float dotAvx2(const float *a, const float *b, size_t n)
+    {
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+        }
+        for (; i + 8 <= n; i += 8)
+        {
+            acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        }
+        __m256 acc = _mm256_add_ps(acc0, acc1);
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        return _mm_cvtss_f32(sum) + dotScalar(a + i, b + i, n - i);
+    }
+#endif
+
+#if defined(RESAMPLER_NEON)
+    float dotNeon(const float *a, const float *b, size_t n)
+    {
+        float32x4_t acc0 = vdupq_n_f32(0.0f);
+        float32x4_t acc1 = vdupq_n_f32(0.0f);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+            acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        }
+        float32x4_t acc = vaddq_f32(acc0, acc1);
+        float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+        return vget_lane_f32(vpadd_f32(sum, sum), 0) + dotScalar(a + i, b + i, n - i);
+    }
+#endif
+
+    DotKernel selectDot()
+    {
+#if defined(RESAMPLER_X86)
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init(); // required when called from a static initializer
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            return dotAvx2;
+        }
+#endif
+        return dotSse2;
+#elif defined(RESAMPLER_NEON)
+        return dotNeon;
+#else
+        return dotScalar;
+#endif
+    }
+
+    const DotKernel g_dot = selectDot();
+}
+
+Resampler::Resampler(unsigned int inputRate, unsigned int outputRate, size_t maxInputChunk)
+    : inputRate_(inputRate), outputRate_(outputRate), up_(1), down_(1), taps_(0), bank_(nullptr),
+      newest_(0), phase_(0)
+{
+    if (const BankInfo *bank = findBank(inputRate, outputRate))
+    {
+        up_ = bank->up;
+        down_ = bank->down;
+        taps_ = bank->taps;
+        bank_ = bank->coefficients;
+        history_.reserve(taps_ + maxInputChunk);
+    }
+    reset();
+}
+
+bool Resampler::isSupported(unsigned int inputRate, unsigned int outputRate)
+{
+    return findBank(inputRate, outputRate) != nullptr;
+}
+
+bool Resampler::isValid() const
+{
+    return bank_ != nullptr;
+}
+
+void Resampler::reset()
+{
+    if (!bank_)
+    {
+        return;
+    }
+    history_.assign(taps_ - 1, 0.0f);
+    newest_ = taps_ - 1;
+    phase_ = 0;
+}
+
+size_t Resampler::maxOutputFor(size_t numSamples) const
+{
+    return (numSamples + taps_) * up_ / down_ + 2;
+}
+
+size_t Resampler::process(const float *input, size_t numSamples, float *output, size_t outputCapacity)
+{
+    if (!bank_ || !output)
+    {
+        return 0;
+    }
+
+    if (input && numSamples > 0)
+    {
+        history_.insert(history_.end(), input, input + numSamples);
+    }
+
+    size_t produced = 0;
+    const size_t available = history_.size();
+    const float *samples = history_.data();
+
+    while (newest_ < available && produced < outputCapacity)
+    {
+        output[produced++] = g_dot(bank_ + static_cast<size_t>(phase_) * taps_, samples + newest_ + 1 - taps_, taps_);
+
+        // Advance M steps on the L-times upsampled grid
+        phase_ += down_;
+        newest_ += phase_ / up_;
+        phase_ %= up_;
+    }
+
+    // Keep only the history the next output still needs
+    const size_t consumed = std::min(newest_ + 1 - taps_, history_.size());
+    if (consumed > 0)
+    {
+        history_.erase(history_.begin(), history_.begin() + static_cast<std::ptrdiff_t>(consumed));
+        newest_ -= consumed;
+    }
+
+    return produced;
+}
+
+size_t Resampler::flush(float *output, size_t outputCapacity)
+{
+    if (!bank_ || !output)
+    {
+        return 0;
+    }
+
+    // Group delay of the L*T-tap prototype, in input samples
+    const size_t delay = (static_cast<size_t>(up_) * taps_ + up_ - 1) / (2 * up_);
+    history_.insert(history_.end(), delay, 0.0f);
+
+    const size_t produced = process(nullptr, 0, output, outputCapacity);
+    reset();
+    return produced;
+}
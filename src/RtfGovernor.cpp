@@ -0,0 +1,57 @@
+#include "RtfGovernor.h"
+#include <algorithm>
+
+RtfGovernor::RtfGovernor(const Config &config)
+    : config_(config), stepsDown_(0), stepsUp_(0)
+{
+    config_.maxLevel = std::max(0, config_.maxLevel);
+    config_.smoothing = std::min(1.0, std::max(0.01, config_.smoothing));
+    reset();
+}
+
+int RtfGovernor::update(double audioSeconds, double decodeSeconds)
+{
+    if (audioSeconds <= 0.0)
+    {
+        return level_;
+    }
+
+    const double sample = decodeSeconds / audioSeconds;
+    rtf_ = measured_ ? rtf_ + config_.smoothing * (sample - rtf_) : sample;
+    measured_ = true;
+
+    if (settleLeft_ > 0)
+    {
+        settleLeft_--;
+        return level_;
+    }
+
+    const int previous = level_;
+    if (rtf_ > config_.highRtf && level_ < config_.maxLevel)
+    {
+        level_++;
+        stepsDown_++;
+    }
+    else if (rtf_ < config_.lowRtf && level_ > 0)
+    {
+        level_--;
+        stepsUp_++;
+    }
+
+    if (level_ != previous)
+    {
+        // The average spans decodes at the old level; restart it at the new one
+        settleLeft_ = config_.settleDecodes;
+        measured_ = false;
+    }
+
+    return level_;
+}
+
+void RtfGovernor::reset()
+{
+    level_ = 0;
+    rtf_ = 0.0;
+    measured_ = false;
+    settleLeft_ = 0;
+}
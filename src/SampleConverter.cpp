@@ -0,0 +1,353 @@
+#include "SampleConverter.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#define SAMPLE_CONVERTER_X86 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SAMPLE_CONVERTER_NEON 1
+#endif
+
+namespace
+{
+    using Kernel = void (*)(const void *input, size_t frames, float *output, float scale);
+
+    constexpr float formatScale(SampleFormat format)
+    {
+        switch (format)
+        {
+        case SampleFormat::Int16:
+            return 1.0f / 32768.0f;
+        case SampleFormat::Int32:
+            return 1.0f / 2147483648.0f;
+        default:
+            return 1.0f;
+        }
+    }
+
+    template <SampleFormat F>
+    inline float loadScalar(const void *input, size_t index)
+    {
+        if constexpr (F == SampleFormat::Float32)
+        {
+            return static_cast<const float *>(input)[index];
+        }
+        else if constexpr (F == SampleFormat::Int16)
+        {
+            return static_cast<float>(static_cast<const int16_t *>(input)[index]);
+        }
+        else
+        {
+            return static_cast<float>(static_cast<const int32_t *>(input)[index]);
+        }
+    }
+
+    /**
+     * @brief Scalar convert/downmix for frames [begin, frames); also used for SIMD tails
+     */
+    template <SampleFormat F>
+    void scalarRange(const void *input, size_t begin, size_t frames, unsigned int channels, float *output, float scale)
+    {
+        const float frameScale = scale / static_cast<float>(channels);
+        for (size_t i = begin; i < frames; i++)
+        {
+            float sum = 0.0f;
+            for (unsigned int ch = 0; ch < channels; ch++)
+            {
+                sum += loadScalar<F>(input, i * channels + ch);
+            }
+            output[i] = sum * frameScale;
+        }
+    }
+
+    template <SampleFormat F, unsigned int CH>
+    void scalarKernel(const void *input, size_t frames, float *output, float scale)
+    {
+        scalarRange<F>(input, 0, frames, CH, output, scale);
+    }
+
+#if defined(SAMPLE_CONVERTER_X86)
+    // ------------------------------------------------------------------
+    // SSE2 (baseline on x86-64): 4 frames per iteration
+    // ------------------------------------------------------------------
+
+    template <SampleFormat F>
+    inline __m128 loadSse2(const void *input, size_t index)
+    {
+        if constexpr (F == SampleFormat::Float32)
+        {
+            return _mm_loadu_ps(static_cast<const float *>(input) + index);
+        }
+        else if constexpr (F == SampleFormat::Int16)
+        {
+            __m128i s16 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(static_cast<const int16_t *>(input) + index));
+            return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s16, s16), 16));
+        }
+        else
+        {
+            return _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(static_cast<const int32_t *>(input) + index)));
+        }
+    }
+
+    /// [x0+x1, x2+x3, y0+y1, y2+y3]
+    inline __m128 pairAddSse2(__m128 x, __m128 y)
+    {
+        return _mm_add_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0)),
+                          _mm_shuffle_ps(x, y, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+
+    /// Sum CH consecutive vectors of interleaved samples into one vector of per-frame totals
+    template <SampleFormat F, unsigned int CH>
+    inline __m128 foldSse2(const void *input, size_t index)
+    {
+        if constexpr (CH == 1)
+        {
+            return loadSse2<F>(input, index);
+        }
+        else
+        {
+            return pairAddSse2(foldSse2<F, CH / 2>(input, index),
+                               foldSse2<F, CH / 2>(input, index + CH / 2 * 4));
+        }
+    }
+
+    template <SampleFormat F, unsigned int CH>
+    void sse2Kernel(const void *input, size_t frames, float *output, float scale)
+    {
+        const __m128 vscale = _mm_set1_ps(scale / CH);
+        size_t i = 0;
+        for (; i + 4 <= frames; i += 4)
+        {
+            _mm_storeu_ps(output + i, _mm_mul_ps(foldSse2<F, CH>(input, i * CH), vscale));
+        }
+        scalarRange<F>(input, i, frames, CH, output, scale);
+    }
+
+    // ------------------------------------------------------------------
+    // AVX2: 8 frames per iteration, selected at runtime
+    // ------------------------------------------------------------------
+
+    template <SampleFormat F>
+    __attribute__((target("avx2"))) inline __m256 loadAvx2(const void *input, size_t index)
+    {
+        if constexpr (F == SampleFormat::Float32)
+        {
+            return _mm256_loadu_ps(static_cast<const float *>(input) + index);
+        }
+        else if constexpr (F == SampleFormat::Int16)
+        {
+            __m128i s16 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(static_cast<const int16_t *>(input) + index));
+            return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(s16));
+        }
+        else
+        {
+            return _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(static_cast<const int32_t *>(input) + index)));
+        }
+    }
+
+    /// [x0+x1, x2+x3, x4+x5, x6+x7, y0+y1, ..., y6+y7]
+    __attribute__((target("avx2"))) inline __m256 pairAddAvx2(__m256 x, __m256 y)
+    {
+        // hadd works per 128-bit lane; restore linear order of the 64-bit pairs
+        __m256 h = _mm256_hadd_ps(x, y);
+        return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(h), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    template <SampleFormat F, unsigned int CH>
+    __attribute__((target("avx2"))) inline __m256 foldAvx2(const void *input, size_t index)
+    {
+        if constexpr (CH == 1)
+        {
+            return loadAvx2<F>(input, index);
+        }
+        else
+        {
+            return pairAddAvx2(foldAvx2<F, CH / 2>(input, index),
+                               foldAvx2<F, CH / 2>(input, index + CH / 2 * 8));
+        }
+    }
+
+    template <SampleFormat F, unsigned int CH>
+    __attribute__((target("avx2"))) void avx2Kernel(const void *input, size_t frames, float *output, float scale)
+    {
+        const __m256 vscale = _mm256_set1_ps(scale / CH);
+        size_t i = 0;
+        for (; i + 8 <= frames; i += 8)
+        {
+            _mm256_storeu_ps(output + i, _mm256_mul_ps(foldAvx2<F, CH>(input, i * CH), vscale));
+        }
+        scalarRange<F>(input, i, frames, CH, output, scale);
+    }
+#endif
+
+#if defined(SAMPLE_CONVERTER_NEON)
+    // ------------------------------------------------------------------
+    // NEON: 4 frames per iteration
+    // ------------------------------------------------------------------
+
+    template <SampleFormat F>
+    inline float32x4_t loadNeon(const void *input, size_t index)
+    {
+        if constexpr (F == SampleFormat::Float32)
+        {
+            return vld1q_f32(static_cast<const float *>(input) + index);
+        }
+        else if constexpr (F == SampleFormat::Int16)
+        {
+            return vcvtq_f32_s32(vmovl_s16(vld1_s16(static_cast<const int16_t *>(input) + index)));
+        }
+        else
+        {
+            return vcvtq_f32_s32(vld1q_s32(static_cast<const int32_t *>(input) + index));
+        }
+    }
+
+    /// [x0+x1, x2+x3, y0+y1, y2+y3]
+    inline float32x4_t pairAddNeon(float32x4_t x, float32x4_t y)
+    {
+#if defined(__aarch64__)
+        return vpaddq_f32(x, y);
+#else
+        return vcombine_f32(vpadd_f32(vget_low_f32(x), vget_high_f32(x)),
+                            vpadd_f32(vget_low_f32(y), vget_high_f32(y)));
+#endif
+    }
+
+    template <SampleFormat F, unsigned int CH>
+    inline float32x4_t foldNeon(const void *input, size_t index)
+    {
+        if constexpr (CH == 1)
+        {
+            return loadNeon<F>(input, index);
+        }
+        else
+        {
+            return pairAddNeon(foldNeon<F, CH / 2>(input, index),
+                               foldNeon<F, CH / 2>(input, index + CH / 2 * 4));
+        }
+    }
+
+    template <SampleFormat F, unsigned int CH>
+    void neonKernel(const void *input, size_t frames, float *output, float scale)
+    {
+        const float32x4_t vscale = vdupq_n_f32(scale / CH);
+        size_t i = 0;
+        for (; i + 4 <= frames; i += 4)
+        {
+            vst1q_f32(output + i, vmulq_f32(foldNeon<F, CH>(input, i * CH), vscale));
+        }
+        scalarRange<F>(input, i, frames, CH, output, scale);
+    }
+#endif
+
+    constexpr int FORMAT_COUNT = 3;
+    constexpr int LAYOUT_COUNT = 4; // 1, 2, 4, 8 channels
+
+    struct KernelTable
+    {
+        Kernel kernels[FORMAT_COUNT][LAYOUT_COUNT];
+        const char *name;
+    };
+
+#define SAMPLE_CONVERTER_ROW(KERNEL, F) \
+    {KERNEL<F, 1>, KERNEL<F, 2>, KERNEL<F, 4>, KERNEL<F, 8>}
+#define SAMPLE_CONVERTER_TABLE(KERNEL, NAME)                         \
+    KernelTable                                                      \
+    {                                                                \
+        {SAMPLE_CONVERTER_ROW(KERNEL, SampleFormat::Float32),        \
+         SAMPLE_CONVERTER_ROW(KERNEL, SampleFormat::Int16),          \
+         SAMPLE_CONVERTER_ROW(KERNEL, SampleFormat::Int32)},         \
+            NAME                                                     \
+    }
+
+    KernelTable selectKernels()
+    {
+#if defined(SAMPLE_CONVERTER_X86)
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init(); // required when called from a static initializer
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return SAMPLE_CONVERTER_TABLE(avx2Kernel, "avx2");
+        }
+#endif
+        return SAMPLE_CONVERTER_TABLE(sse2Kernel, "sse2");
+#elif defined(SAMPLE_CONVERTER_NEON)
+        return SAMPLE_CONVERTER_TABLE(neonKernel, "neon");
+#else
+        return SAMPLE_CONVERTER_TABLE(scalarKernel, "scalar");
+#endif
+    }
+
+#undef SAMPLE_CONVERTER_TABLE
+#undef SAMPLE_CONVERTER_ROW
+
+    // Resolved during static initialization so the audio thread never pays for dispatch
+    const KernelTable g_kernels = selectKernels();
+
+    int layoutIndex(unsigned int channels)
+    {
+        switch (channels)
+        {
+        case 1:
+            return 0;
+        case 2:
+            return 1;
+        case 4:
+            return 2;
+        case 8:
+            return 3;
+        default:
+            return -1;
+        }
+    }
+}
+
+void SampleConverter::toMono(const void *input, SampleFormat format, size_t frames, unsigned int channels, float *output)
+{
+    if (!input || !output || frames == 0 || channels == 0)
+    {
+        return;
+    }
+
+    const float scale = formatScale(format);
+    const int layout = layoutIndex(channels);
+
+    if (layout >= 0)
+    {
+        g_kernels.kernels[static_cast<int>(format)][layout](input, frames, output, scale);
+        return;
+    }
+
+    switch (format)
+    {
+    case SampleFormat::Float32:
+        scalarRange<SampleFormat::Float32>(input, 0, frames, channels, output, scale);
+        break;
+    case SampleFormat::Int16:
+        scalarRange<SampleFormat::Int16>(input, 0, frames, channels, output, scale);
+        break;
+    case SampleFormat::Int32:
+        scalarRange<SampleFormat::Int32>(input, 0, frames, channels, output, scale);
+        break;
+    }
+}
+
+size_t SampleConverter::bytesPerSample(SampleFormat format)
+{
+    switch (format)
+    {
+    case SampleFormat::Int16:
+        return sizeof(int16_t);
+    case SampleFormat::Int32:
+        return sizeof(int32_t);
+    default:
+        return sizeof(float);
+    }
+}
+
+const char *SampleConverter::backendName()
+{
+    return g_kernels.name;
+}
@@ -0,0 +1,304 @@
+#include "TranscriptionServer.h"
+#include "VoiceActivityDetector.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+TranscriptionServer::TranscriptionServer(const Config &config)
+    : config_(config), model_(nullptr), stopping_(false), nextId_(1),
+      chunksProcessed_(0), audioSeconds_(0.0), busySeconds_(0.0)
+{
+}
+
+TranscriptionServer::~TranscriptionServer()
+{
+    shutdown();
+}
+
+bool TranscriptionServer::initialize()
+{
+    if (model_)
+    {
+        return true;
+    }
+
+    whisper_bridge_params params = {};
+    params.model_path = config_.modelPath.c_str();
+    params.language = config_.language.c_str();
+    params.threads = config_.threadsPerWorker;
+    params.max_len_ms = static_cast<int>(config_.maxChunkSeconds * 1000);
+    params.use_gpu = config_.useGpu;
+
+    model_ = whisper_bridge_init(params);
+    if (!model_)
+    {
+        std::cerr << "Failed to load Whisper model: " << config_.modelPath << std::endl;
+        return false;
+    }
+
+    stopping_ = false;
+    const int workers = std::max(1, config_.workers);
+    for (int i = 0; i < workers; i++)
+    {
+        workers_.emplace_back(&TranscriptionServer::workerThreadFunction, this);
+    }
+
+    std::cout << "Transcription server: " << workers << " workers x " << config_.threadsPerWorker
+              << " threads, up to " << config_.maxSessions << " sessions" << std::endl;
+    return true;
+}
+
+void TranscriptionServer::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+
+    for (auto &worker : workers_)
+    {
+        worker.join();
+    }
+    workers_.clear();
+
+    std::unordered_map<SessionId, std::shared_ptr<Session>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions.swap(sessions_);
+        readyQueue_.clear();
+    }
+    for (auto &entry : sessions)
+    {
+        whisper_bridge_state_free(entry.second->state);
+    }
+    sessionIdle_.notify_all();
+
+    if (model_)
+    {
+        whisper_bridge_free(model_);
+        model_ = nullptr;
+    }
+}
+
+TranscriptionServer::SessionId TranscriptionServer::openSession(ResultCallback callback)
+{
+    if (!model_)
+    {
+        return 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sessions_.size() >= config_.maxSessions)
+        {
+            std::cerr << "Transcription server: session limit (" << config_.maxSessions << ") reached" << std::endl;
+            return 0;
+        }
+    }
+
+    // Allocating the state is slow; do it outside the lock
+    auto session = std::make_shared<Session>();
+    session->state = whisper_bridge_state_init(model_);
+    if (!session->state)
+    {
+        std::cerr << "Transcription server: failed to create Whisper state" << std::endl;
+        return 0;
+    }
+    session->callback = std::move(callback);
+    session->buffer.reserve(static_cast<size_t>(config_.maxChunkSeconds * 16000));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Another caller may have taken the last slot while the state was allocated
+    if (sessions_.size() >= config_.maxSessions)
+    {
+        whisper_bridge_state_free(session->state);
+        std::cerr << "Transcription server: session limit (" << config_.maxSessions << ") reached" << std::endl;
+        return 0;
+    }
+    session->id = nextId_++;
+    sessions_[session->id] = session;
+    return session->id;
+}
+
+void TranscriptionServer::addAudio(SessionId id, const std::vector<float> &audioData, double timestamp)
+{
+    if (audioData.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(id);
+    if (it == sessions_.end() || it->second->closing)
+    {
+        return;
+    }
+
+    Session &session = *it->second;
+    if (session.buffer.empty())
+    {
+        session.bufferStart = timestamp;
+    }
+    session.buffer.insert(session.buffer.end(), audioData.begin(), audioData.end());
+    scheduleIfReady(it->second);
+}
+
+void TranscriptionServer::closeSession(SessionId id)
+{
+    std::shared_ptr<Session> session;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = sessions_.find(id);
+        if (it == sessions_.end())
+        {
+            return;
+        }
+        session = it->second;
+        session->closing = true;
+        scheduleIfReady(session);
+
+        // Wait until workers have drained the partial chunk
+        sessionIdle_.wait(lock, [&]()
+                          { return stopping_ || (!session->inFlight && !session->queued && session->buffer.empty()); });
+
+        if (sessions_.erase(id) == 0)
+        {
+            return; // Released by shutdown()
+        }
+    }
+
+    whisper_bridge_state_free(session->state);
+    session->state = nullptr;
+}
+
+TranscriptionServer::Stats TranscriptionServer::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.sessions = sessions_.size();
+    stats.readySessions = readyQueue_.size();
+    stats.chunksProcessed = chunksProcessed_;
+    stats.audioSeconds = audioSeconds_;
+    stats.busySeconds = busySeconds_;
+    return stats;
+}
+
+bool TranscriptionServer::isReady(const Session &session) const
+{
+    const size_t chunkSamples = static_cast<size_t>(config_.chunkSeconds * 16000);
+    return session.buffer.size() >= chunkSamples || (session.closing && !session.buffer.empty());
+}
+
+void TranscriptionServer::scheduleIfReady(const std::shared_ptr<Session> &session)
+{
+    if (session->queued || session->inFlight || !isReady(*session))
+    {
+        return;
+    }
+
+    session->queued = true;
+    readyQueue_.push_back(session);
+    workAvailable_.notify_one();
+}
+
+size_t TranscriptionServer::findChunkEnd(const std::vector<float> &audio) const
+{
+    constexpr size_t FRAME_SAMPLES = 320; // 20 ms at 16kHz
+    const float threshold = config_.silenceThreshold * config_.silenceThreshold;
+    const size_t frameCount = audio.size() / FRAME_SAMPLES;
+    const size_t firstFrame = static_cast<size_t>(config_.chunkSeconds * 16000) / 2 / FRAME_SAMPLES;
+    if (frameCount <= firstFrame + 1)
+    {
+        return audio.size();
+    }
+
+    std::vector<float> energy(frameCount, 0.0f);
+    std::vector<uint8_t> speech(frameCount, 0);
+    for (size_t f = firstFrame; f < frameCount; f++)
+    {
+        float zeroCrossingRate = 0.0f;
+        VoiceActivityDetector::frameFeatures(audio.data() + f * FRAME_SAMPLES, FRAME_SAMPLES, energy[f], zeroCrossingRate);
+        speech[f] = energy[f] >= threshold;
+    }
+
+    const size_t endFrame = VoiceActivityDetector::findPause(energy, speech, firstFrame, frameCount);
+    return std::max<size_t>(1, endFrame) * FRAME_SAMPLES;
+}
+
+void TranscriptionServer::workerThreadFunction()
+{
+    const size_t maxChunkSamples = static_cast<size_t>(config_.maxChunkSeconds * 16000);
+    std::vector<float> chunk;
+    chunk.reserve(maxChunkSamples);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        workAvailable_.wait(lock, [this]()
+                            { return stopping_ || !readyQueue_.empty(); });
+        if (stopping_)
+        {
+            break;
+        }
+
+        std::shared_ptr<Session> session = readyQueue_.front();
+        readyQueue_.pop_front();
+        session->queued = false;
+        session->inFlight = true;
+
+        // Look at up to one chunk; addAudio only appends, so the front stays put while unlocked
+        const size_t available = std::min(session->buffer.size(), maxChunkSamples);
+        const bool flushAll = session->closing && available == session->buffer.size();
+        chunk.assign(session->buffer.begin(), session->buffer.begin() + static_cast<std::ptrdiff_t>(available));
+        lock.unlock();
+
+        // End the chunk at a pause; the rest waits for the session's next turn
+        const size_t take = flushAll ? chunk.size() : findChunkEnd(chunk);
+        chunk.resize(take);
+
+        lock.lock();
+        session->buffer.erase(session->buffer.begin(), session->buffer.begin() + static_cast<std::ptrdiff_t>(take));
+        const double chunkStart = session->bufferStart;
+        session->bufferStart += static_cast<double>(take) / 16000.0;
+        lock.unlock();
+
+        const auto started = std::chrono::steady_clock::now();
+        whisper_bridge_result result = whisper_bridge_transcribe_with_state(
+            model_, session->state, chunk.data(), static_cast<int>(chunk.size()), config_.threadsPerWorker);
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        if (result.success && result.text && std::strlen(result.text) > 0 && session->callback)
+        {
+            Result out;
+            out.text = result.text;
+            out.text.erase(0, out.text.find_first_not_of(" \t\n"));
+            out.text.erase(out.text.find_last_not_of(" \t\n") + 1);
+            out.startTime = chunkStart + result.start_time_ms / 1000.0;
+            out.endTime = chunkStart + result.end_time_ms / 1000.0;
+            out.confidence = result.confidence;
+            out.language = result.language ? result.language : config_.language;
+            session->callback(session->id, out);
+        }
+        else if (!result.success)
+        {
+            std::cerr << "Session " << session->id << ": "
+                      << (result.error_msg ? result.error_msg : "Unknown error") << std::endl;
+        }
+        whisper_bridge_free_result(&result);
+
+        lock.lock();
+        session->inFlight = false;
+        chunksProcessed_++;
+        audioSeconds_ += static_cast<double>(chunk.size()) / 16000.0;
+        busySeconds_ += elapsed;
+
+        // Back of the queue: other ready sessions get a worker first
+        scheduleIfReady(session);
+        if (session->closing)
+        {
+            sessionIdle_.notify_all();
+        }
+    }
+}
@@ -0,0 +1,327 @@
+#include "VoiceActivityDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VAD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define VAD_NEON 1
+#endif
+
+namespace
+{
+    /// Sign-change count between x[i-1] and x[i] for i in [begin, count)
+    size_t signChangesScalar(const float *x, size_t begin, size_t count)
+    {
+        size_t changes = 0;
+        for (size_t i = std::max<size_t>(begin, 1); i < count; i++)
+        {
+            changes += std::signbit(x[i]) != std::signbit(x[i - 1]);
+        }
+        return changes;
+    }
+
+    float sumSquaresScalar(const float *x, size_t begin, size_t count)
+    {
+        float sum = 0.0f;
+        for (size_t i = begin; i < count; i++)
+        {
+            sum += x[i] * x[i];
+        }
+        return sum;
+    }
+}
+
+VoiceActivityDetector::VoiceActivityDetector(const Config &config)
+    : config_(config)
+{
+    // Only 10/20/30 ms frames are supported; anything else snaps to 20 ms
+    if (config_.frameMs != 10 && config_.frameMs != 20 && config_.frameMs != 30)
+    {
+        config_.frameMs = 20;
+    }
+
+    frameSamples_ = std::max<size_t>(1, static_cast<size_t>(config_.sampleRate) * config_.frameMs / 1000);
+    onsetFrames_ = std::max(1u, config_.onsetMs / config_.frameMs);
+    hangoverFrames_ = std::max(1u, config_.hangoverMs / config_.frameMs);
+    preRollFrames_ = config_.preRollMs / config_.frameMs + onsetFrames_;
+
+    frame_.assign(frameSamples_, 0.0f);
+    preRoll_.assign(preRollFrames_ * frameSamples_, 0.0f);
+    reset();
+}
+
+void VoiceActivityDetector::setCallbacks(SpeechCallback onSpeech, EndCallback onSpeechEnd)
+{
+    onSpeech_ = std::move(onSpeech);
+    onSpeechEnd_ = std::move(onSpeechEnd);
+}
+
+void VoiceActivityDetector::reset()
+{
+    frameFill_ = 0;
+    framesSeen_ = 0;
+    originTime_ = 0.0;
+    anchored_ = false;
+    noiseFloor_ = -1.0f; // Seeded from the first frame
+    speaking_ = false;
+    speechRun_ = 0;
+    hangoverLeft_ = 0;
+    preRollHead_ = 0;
+    preRollCount_ = 0;
+}
+
+bool VoiceActivityDetector::isSpeaking() const
+{
+    return speaking_;
+}
+
+float VoiceActivityDetector::getNoiseFloor() const
+{
+    return std::max(0.0f, noiseFloor_);
+}
+
+double VoiceActivityDetector::frameTime(uint64_t frameIndex) const
+{
+    return originTime_ + static_cast<double>(frameIndex * frameSamples_) / config_.sampleRate;
+}
+
+void VoiceActivityDetector::process(const float *samples, size_t count, double timestamp)
+{
+    if (!samples || count == 0)
+    {
+        return;
+    }
+
+    if (!anchored_)
+    {
+        originTime_ = timestamp;
+        anchored_ = true;
+    }
+
+    // Whole frames straight from the input; partial frames through frame_
+    while (count > 0)
+    {
+        if (frameFill_ == 0 && count >= frameSamples_)
+        {
+            processFrame(samples);
+            samples += frameSamples_;
+            count -= frameSamples_;
+            continue;
+        }
+
+        const size_t take = std::min(count, frameSamples_ - frameFill_);
+        std::memcpy(frame_.data() + frameFill_, samples, take * sizeof(float));
+        frameFill_ += take;
+        samples += take;
+        count -= take;
+
+        if (frameFill_ == frameSamples_)
+        {
+            processFrame(frame_.data());
+            frameFill_ = 0;
+        }
+    }
+}
+
+void VoiceActivityDetector::flush()
+{
+    if (speaking_)
+    {
+        // Deliver the partial frame as part of the utterance
+        if (frameFill_ > 0 && onSpeech_)
+        {
+            onSpeech_(frame_.data(), frameFill_, frameTime(framesSeen_));
+        }
+        speaking_ = false;
+        hangoverLeft_ = 0;
+        if (onSpeechEnd_)
+        {
+            onSpeechEnd_(frameTime(framesSeen_) + static_cast<double>(frameFill_) / config_.sampleRate);
+        }
+    }
+    frameFill_ = 0;
+    speechRun_ = 0;
+    preRollCount_ = 0;
+}
+
+void VoiceActivityDetector::processFrame(const float *frame)
+{
+    const uint64_t index = framesSeen_++;
+
+    float energy = 0.0f;
+    float zcr = 0.0f;
+    frameFeatures(frame, frameSamples_, energy, zcr);
+
+    if (noiseFloor_ < 0.0f)
+    {
+        noiseFloor_ = energy;
+    }
+
+    const float threshold = std::max(config_.minEnergy, noiseFloor_ * config_.noiseRatio);
+    // High zero-crossing rate at modest energy is hiss or fan noise; loud frames count regardless
+    const bool isSpeech = energy > threshold && (zcr < config_.maxZeroCrossingRate || energy > 4.0f * threshold);
+
+    // Track the floor on non-speech, drop to quieter frames immediately, creep up slowly during speech
+    if (energy < noiseFloor_)
+    {
+        noiseFloor_ = energy;
+    }
+    else if (!isSpeech)
+    {
+        noiseFloor_ += config_.noiseAdaptRate * (energy - noiseFloor_);
+    }
+    else
+    {
+        noiseFloor_ += 0.001f * (energy - noiseFloor_);
+    }
+
+    // Remember the frame for pre-roll
+    std::memcpy(preRoll_.data() + preRollHead_ * frameSamples_, frame, frameSamples_ * sizeof(float));
+    preRollHead_ = (preRollHead_ + 1) % preRollFrames_;
+    preRollCount_ = std::min(preRollCount_ + 1, preRollFrames_);
+
+    if (!speaking_)
+    {
+        speechRun_ = isSpeech ? speechRun_ + 1 : 0;
+        if (speechRun_ < onsetFrames_)
+        {
+            return;
+        }
+
+        // Onset: replay the ring (pre-roll plus onset frames, including this one)
+        speaking_ = true;
+        speechRun_ = 0;
+        hangoverLeft_ = hangoverFrames_;
+        if (onSpeech_)
+        {
+            const size_t oldest = (preRollHead_ + preRollFrames_ - preRollCount_) % preRollFrames_;
+            for (size_t k = 0; k < preRollCount_; k++)
+            {
+                const size_t slot = (oldest + k) % preRollFrames_;
+                onSpeech_(preRoll_.data() + slot * frameSamples_, frameSamples_, frameTime(index + 1 - preRollCount_ + k));
+            }
+        }
+        preRollCount_ = 0;
+        return;
+    }
+
+    if (onSpeech_)
+    {
+        onSpeech_(frame, frameSamples_, frameTime(index));
+    }
+
+    if (isSpeech)
+    {
+        hangoverLeft_ = hangoverFrames_;
+    }
+    else if (--hangoverLeft_ == 0)
+    {
+        speaking_ = false;
+        preRollCount_ = 0;
+        if (onSpeechEnd_)
+        {
+            onSpeechEnd_(frameTime(index + 1));
+        }
+    }
+}
+
+void VoiceActivityDetector::frameFeatures(const float *samples, size_t count, float &energy, float &zeroCrossingRate)
+{
+    energy = 0.0f;
+    zeroCrossingRate = 0.0f;
+    if (!samples || count == 0)
+    {
+        return;
+    }
+
+    float sumSquares = 0.0f;
+    size_t changes = 0;
+    size_t i = 0;
+
+#if defined(VAD_SSE2)
+    __m128 acc = _mm_setzero_ps();
+    __m128i crossings = _mm_setzero_si128();
+    // Sign changes compare x[i..i+3] with x[i-1..i+2], so vector work starts at i = 1
+    for (i = 1; i + 4 <= count; i += 4)
+    {
+        const __m128 cur = _mm_loadu_ps(samples + i);
+        const __m128 prev = _mm_loadu_ps(samples + i - 1);
+        acc = _mm_add_ps(acc, _mm_mul_ps(cur, cur));
+        // Sign bits differ -> xor has bit 31 set -> arithmetic shift gives -1
+        crossings = _mm_sub_epi32(crossings, _mm_srai_epi32(_mm_castps_si128(_mm_xor_ps(cur, prev)), 31));
+    }
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    sumSquares = _mm_cvtss_f32(acc) + samples[0] * samples[0];
+
+    alignas(16) int32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), crossings);
+    changes = static_cast<size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+#elif defined(VAD_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    uint32x4_t crossings = vdupq_n_u32(0);
+    for (i = 1; i + 4 <= count; i += 4)
+    {
+        const float32x4_t cur = vld1q_f32(samples + i);
+        const float32x4_t prev = vld1q_f32(samples + i - 1);
+        acc = vmlaq_f32(acc, cur, cur);
+        const uint32x4_t diff = veorq_u32(vreinterpretq_u32_f32(cur), vreinterpretq_u32_f32(prev));
+        crossings = vaddq_u32(crossings, vshrq_n_u32(diff, 31));
+    }
+    float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sumSquares = vget_lane_f32(vpadd_f32(sum, sum), 0) + samples[0] * samples[0];
+    uint32x2_t c = vadd_u32(vget_low_u32(crossings), vget_high_u32(crossings));
+    changes = vget_lane_u32(vpadd_u32(c, c), 0);
+#else
+    sumSquares = samples[0] * samples[0];
+    i = 1;
+#endif
+
+    sumSquares += sumSquaresScalar(samples, i, count);
+    changes += signChangesScalar(samples, i, count);
+
+    energy = sumSquares / static_cast<float>(count);
+    zeroCrossingRate = count > 1 ? static_cast<float>(changes) / static_cast<float>(count - 1) : 0.0f;
+}
+
+size_t VoiceActivityDetector::findPause(const std::vector<float> &energy, const std::vector<uint8_t> &speech, size_t begin, size_t end)
+{
+    end = std::min({end, energy.size(), speech.size()});
+    size_t bestStart = 0;
+    size_t bestLength = 0;
+    size_t runStart = 0;
+    size_t runLength = 0;
+    size_t quietest = begin;
+
+    for (size_t f = begin; f < end; f++)
+    {
+        if (energy[f] < energy[quietest])
+        {
+            quietest = f;
+        }
+
+        if (!speech[f])
+        {
+            if (runLength == 0)
+            {
+                runStart = f;
+            }
+            runLength++;
+            if (runLength > bestLength)
+            {
+                bestStart = runStart;
+                bestLength = runLength;
+            }
+        }
+        else
+        {
+            runLength = 0;
+        }
+    }
+
+    return bestLength > 0 ? bestStart + bestLength / 2 : quietest;
+}
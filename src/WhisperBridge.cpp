@@ -7,18 +7,132 @@
 #include <memory>
 #include <cstring>
 #include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 // Internal implementation struct (can use whisper/ggml types here)
+struct whisper_bridge_state {
+    struct whisper_state* state;
+
+    whisper_bridge_state() : state(nullptr) {}
+};
+
+// Sliding-window stream state
+struct whisper_bridge_stream {
+    whisper_bridge_stream_params params;
+    std::vector<float> window;               // Carried-over audio followed by new audio
+    size_t keep_samples;                     // Leading samples already covered by the last final result
+    size_t new_samples;                      // Samples added since the last decode
+    double window_start;                     // Stream time of window[0] in seconds
+    bool anchored;                           // window_start taken from an add_audio timestamp
+    std::vector<whisper_token> prompt;       // Committed tokens fed to the next decode
+    std::vector<whisper_token> committed_tail; // Last committed tokens, aligned against the next window
+
+    whisper_bridge_stream() : params(), keep_samples(0), new_samples(0), window_start(0.0), anchored(false) {}
+};
+
 struct whisper_bridge_context {
-    struct whisper_context* ctx;
+    struct whisper_context* ctx;   // Shared model weights, owned by the registry
+    std::string model_key;
+    whisper_bridge_state* state;   // Decoding state for whisper_bridge_transcribe_audio, created on first use
     whisper_bridge_params params;
     whisper_bridge_callback callback;
     void* user_data;
     bool streaming;
+    whisper_bridge_stream stream;
+    whisper_bridge_segment_callback segment_callback;   // Incremental segments of whisper_bridge_transcribe_audio
+    void* segment_user_data;
+    whisper_bridge_progress_callback progress_callback;
+    void* progress_user_data;
+    whisper_bridge_decode_params decode;   // Used by calls that do not pass their own parameters
+    std::string decode_language;           // Storage behind decode.language
+    std::string decode_vad_model;          // Storage behind decode.vad_model_path
     
-    whisper_bridge_context() : ctx(nullptr), callback(nullptr), user_data(nullptr), streaming(false) {}
+    whisper_bridge_context() : ctx(nullptr), state(nullptr), callback(nullptr), user_data(nullptr), streaming(false),
+                               segment_callback(nullptr), segment_user_data(nullptr),
+                               progress_callback(nullptr), progress_user_data(nullptr) {}
 };
 
+// Model registry: one set of weights per (path, gpu) no matter how many contexts use it
+namespace {
+    // Ask the kernel to start reading the whole file; the pages stay cached after the mapping is gone
+    void prefault_file(const char* path) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return;
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            if (mapping != MAP_FAILED) {
+                madvise(mapping, static_cast<size_t>(st.st_size), MADV_WILLNEED);
+                munmap(mapping, static_cast<size_t>(st.st_size));
+            }
+        }
+        close(fd);
+#else
+        (void)path;
+#endif
+    }
+
+    struct registry_entry {
+        struct whisper_context* ctx;
+        int refs;
+    };
+
+    std::mutex g_registry_mutex;
+    std::unordered_map<std::string, registry_entry> g_registry;
+
+    std::string registry_key(const whisper_bridge_params& params) {
+        return std::string(params.model_path ? params.model_path : "") + (params.use_gpu ? "#gpu" : "#cpu");
+    }
+
+    struct whisper_context* registry_acquire(const whisper_bridge_params& params, const std::string& key) {
+        std::lock_guard<std::mutex> lock(g_registry_mutex);
+
+        auto it = g_registry.find(key);
+        if (it != g_registry.end()) {
+            it->second.refs++;
+            return it->second.ctx;
+        }
+
+        if (params.prefault && params.model_path) {
+            prefault_file(params.model_path);
+        }
+
+        // Weights only; every user creates its own whisper_state
+        struct whisper_context_params cparams = whisper_context_default_params();
+        cparams.use_gpu = params.use_gpu;
+
+        struct whisper_context* ctx = whisper_init_from_file_with_params_no_state(params.model_path, cparams);
+        if (ctx) {
+            g_registry[key] = registry_entry{ctx, 1};
+        }
+        return ctx;
+    }
+
+    void registry_release(const std::string& key) {
+        std::lock_guard<std::mutex> lock(g_registry_mutex);
+
+        auto it = g_registry.find(key);
+        if (it == g_registry.end()) return;
+
+        if (--it->second.refs == 0) {
+            whisper_free(it->second.ctx);
+            g_registry.erase(it);
+        }
+    }
+}
+
 // Helper function to allocate and copy string
 static char* allocate_string(const std::string& str) {
     if (str.empty()) return nullptr;
@@ -29,15 +143,258 @@ static char* allocate_string(const std::string& str) {
     return result;
 }
 
+// Copy parameters into the context, taking ownership of the strings
+static void store_decode_params(whisper_bridge_context* ctx, const whisper_bridge_decode_params& params) {
+    const whisper_bridge_profile profile = ctx->decode.profile; // Only whisper_bridge_set_profile changes it
+    ctx->decode_language = params.language ? params.language : ctx->decode_language;
+    ctx->decode_vad_model = params.vad_model_path ? params.vad_model_path : "";
+    ctx->decode = params;
+    ctx->decode.profile = profile;
+    ctx->decode.language = ctx->decode_language.c_str();
+    ctx->decode.vad_model_path = ctx->decode_vad_model.empty() ? nullptr : ctx->decode_vad_model.c_str();
+}
+
+// Text tokens only: timestamp and other special tokens sort after end-of-text. Confidence and
+// token arrays are computed over these everywhere.
+static bool is_text_token(whisper_token id, whisper_token eot) {
+    return id < eot;
+}
+
+// Copy the decoded segments [first_segment, end_segment) and their text tokens into one allocation:
+// segment and token arrays, then the full text and every segment/token string. Sized in a first
+// pass over the state.
+static bool fill_result_arena(whisper_bridge_result& result, struct whisper_context* wctx, struct whisper_state* state,
+                              int first_segment, int end_segment) {
+    const whisper_token eot = whisper_token_eot(wctx);
+    const int n_segments = end_segment - first_segment;
+
+    size_t n_tokens = 0;
+    size_t text_bytes = 1; // Full text terminator
+    for (int i = first_segment; i < end_segment; ++i) {
+        const char* seg_text = whisper_full_get_segment_text_from_state(state, i);
+        const size_t len = seg_text ? strlen(seg_text) : 0;
+        text_bytes += 2 * len + 1; // In the full text and on its own
+        const int count = whisper_full_n_tokens_from_state(state, i);
+        for (int j = 0; j < count; ++j) {
+            if (!is_text_token(whisper_full_get_token_id_from_state(state, i, j), eot)) continue;
+            const char* piece = whisper_full_get_token_text_from_state(wctx, state, i, j);
+            text_bytes += (piece ? strlen(piece) : 0) + 1;
+            n_tokens++;
+        }
+    }
+
+    const size_t segments_bytes = static_cast<size_t>(n_segments) * sizeof(whisper_bridge_segment);
+    const size_t tokens_bytes = n_tokens * sizeof(whisper_bridge_token);
+    char* arena = static_cast<char*>(malloc(segments_bytes + tokens_bytes + text_bytes));
+    if (!arena) return false;
+
+    auto* segments = reinterpret_cast<whisper_bridge_segment*>(arena);
+    auto* tokens = reinterpret_cast<whisper_bridge_token*>(arena + segments_bytes);
+    char* full_text = arena + segments_bytes + tokens_bytes;
+    char* cursor = full_text;
+    for (int i = first_segment; i < end_segment; ++i) {
+        const char* seg_text = whisper_full_get_segment_text_from_state(state, i);
+        const size_t len = seg_text ? strlen(seg_text) : 0;
+        memcpy(cursor, seg_text ? seg_text : "", len);
+        cursor += len;
+    }
+    *cursor++ = '\0';
+
+    auto copy_string = [&cursor](const char* str) {
+        const size_t len = str ? strlen(str) : 0;
+        char* out = cursor;
+        memcpy(out, str ? str : "", len);
+        out[len] = '\0';
+        cursor += len + 1;
+        return out;
+    };
+
+    int token_index = 0;
+    float p_total = 0.0f;
+    for (int i = first_segment; i < end_segment; ++i) {
+        whisper_bridge_segment& segment = segments[i - first_segment];
+        segment.text = copy_string(whisper_full_get_segment_text_from_state(state, i));
+        segment.start_time_ms = whisper_full_get_segment_t0_from_state(state, i) * 10;
+        segment.end_time_ms = whisper_full_get_segment_t1_from_state(state, i) * 10;
+        segment.no_speech_prob = whisper_full_get_segment_no_speech_prob_from_state(state, i);
+        segment.first_token = token_index;
+
+        float p_sum = 0.0f;
+        const int count = whisper_full_n_tokens_from_state(state, i);
+        for (int j = 0; j < count; ++j) {
+            const whisper_token_data data = whisper_full_get_token_data_from_state(state, i, j);
+            if (!is_text_token(data.id, eot)) continue;
+
+            whisper_bridge_token& token = tokens[token_index++];
+            token.id = data.id;
+            token.text = copy_string(whisper_full_get_token_text_from_state(wctx, state, i, j));
+            token.p = data.p;
+            token.plog = data.plog;
+            token.t0_ms = data.t0 * 10;
+            token.t1_ms = data.t1 * 10;
+            p_sum += data.p;
+        }
+
+        segment.n_tokens = token_index - segment.first_token;
+        segment.confidence = segment.n_tokens > 0 ? p_sum / segment.n_tokens : 0.0f;
+        p_total += p_sum;
+    }
+
+    result.arena = arena;
+    result.text = full_text;
+    result.segments = n_segments > 0 ? segments : nullptr;
+    result.n_segments = n_segments;
+    result.tokens = token_index > 0 ? tokens : nullptr;
+    result.n_tokens = token_index;
+    result.confidence = token_index > 0 ? p_total / token_index : 0.0f;
+    result.start_time_ms = n_segments > 0 ? segments[0].start_time_ms : 0;
+    result.end_time_ms = n_segments > 0 ? segments[n_segments - 1].end_time_ms : 0;
+    return true;
+}
+
+static struct whisper_full_params build_wparams(const whisper_bridge_context* ctx, const whisper_bridge_decode_params& dp) {
+    struct whisper_full_params wparams = whisper_full_default_params(
+        dp.strategy == WHISPER_BRIDGE_SAMPLING_BEAM_SEARCH ? WHISPER_SAMPLING_BEAM_SEARCH : WHISPER_SAMPLING_GREEDY);
+
+    wparams.language = dp.language ? dp.language : ctx->decode.language;
+    wparams.n_threads = dp.threads > 0 ? dp.threads : ctx->params.threads;
+    wparams.translate = dp.translate;
+    wparams.print_progress = false;
+    wparams.print_timestamps = false;
+
+    wparams.greedy.best_of = std::max(1, dp.best_of);
+    wparams.beam_search.beam_size = std::max(1, dp.beam_size);
+    wparams.temperature = dp.temperature;
+    wparams.temperature_inc = dp.temperature_inc;
+    wparams.entropy_thold = dp.entropy_thold;
+    wparams.logprob_thold = dp.logprob_thold;
+    wparams.no_speech_thold = dp.no_speech_thold;
+    wparams.max_tokens = std::max(0, dp.max_tokens);
+    wparams.suppress_nst = dp.suppress_nst;
+
+    if (dp.vad && dp.vad_model_path && *dp.vad_model_path) {
+        wparams.vad = true;
+        wparams.vad_model_path = dp.vad_model_path;
+        wparams.vad_params.threshold = dp.vad_threshold;
+    }
+
+    return wparams;
+}
+
+// Low-latency profile: most of a 30 s encoder pass is padding for short chunks
+static void apply_profile(struct whisper_full_params& wparams, whisper_bridge_profile profile, int audio_len) {
+    if (profile != WHISPER_BRIDGE_PROFILE_LOW_LATENCY) return;
+
+    const int seconds = (audio_len + 15999) / 16000;
+
+    // 50 encoder positions per second (10 ms mel hop, stride-2 conv); keep ~1 s of slack and
+    // round to 64 positions so nearby chunk lengths share one encoder graph size
+    const int positions = audio_len / 320 + 50;
+    wparams.audio_ctx = std::min(1500, (positions + 63) / 64 * 64);
+
+    // A short chunk is one utterance: skip segmentation and timestamp tokens
+    if (seconds <= 10) {
+        wparams.single_segment = true;
+        wparams.no_timestamps = true;
+    }
+
+    // No temperature fallback re-decodes, and no runaway repetition loops on a truncated context
+    wparams.temperature_inc = 0.0f;
+    const int cap = 16 + 6 * seconds;
+    wparams.max_tokens = wparams.max_tokens > 0 ? std::min(wparams.max_tokens, cap) : cap;
+}
+
+// Called by whisper_full as segments are finalized; forwards each new one with its own timestamps
+static void forward_new_segments(struct whisper_context* wctx, struct whisper_state* state, int n_new, void* user_data) {
+    auto* ctx = static_cast<whisper_bridge_context*>(user_data);
+
+    const int n_segments = whisper_full_n_segments_from_state(state);
+    for (int i = std::max(0, n_segments - n_new); i < n_segments; ++i) {
+        const char* text = whisper_full_get_segment_text_from_state(state, i);
+        if (!text || !*text) continue;
+
+        // Same layout and confidence as a whole transcription result, for this segment alone
+        whisper_bridge_result segment = {};
+        if (!fill_result_arena(segment, wctx, state, i, i + 1)) continue;
+        segment.success = true;
+        segment.language = whisper_lang_str(whisper_full_lang_id_from_state(state));
+        ctx->segment_callback(&segment, ctx->segment_user_data);
+        whisper_bridge_free_result(&segment);
+    }
+}
+
+static void forward_progress(struct whisper_context* wctx, struct whisper_state* state, int progress, void* user_data) {
+    auto* ctx = static_cast<whisper_bridge_context*>(user_data);
+    (void)wctx;
+    (void)state;
+    ctx->progress_callback(progress, ctx->progress_user_data);
+}
+
+static whisper_bridge_result transcribe_impl(
+    whisper_bridge_context* ctx,
+    whisper_bridge_state* state,
+    const float* audio_data,
+    int audio_len,
+    const whisper_bridge_decode_params& decode,
+    bool report_segments) {
+
+    whisper_bridge_result result = {};
+
+    if (!ctx || !ctx->ctx || !state || !state->state || !audio_data) {
+        result.success = false;
+        result.error_msg = allocate_string("Invalid parameters");
+        return result;
+    }
+
+    struct whisper_full_params wparams = build_wparams(ctx, decode);
+    wparams.token_timestamps = true;
+    apply_profile(wparams, decode.profile, audio_len);
+
+    if (report_segments && ctx->segment_callback) {
+        wparams.new_segment_callback = forward_new_segments;
+        wparams.new_segment_callback_user_data = ctx;
+    }
+    if (report_segments && ctx->progress_callback) {
+        wparams.progress_callback = forward_progress;
+        wparams.progress_callback_user_data = ctx;
+    }
+
+    int ret = whisper_full_with_state(ctx->ctx, state->state, wparams, audio_data, audio_len);
+    if (ret != 0) {
+        result.success = false;
+        result.error_msg = allocate_string("Transcription failed");
+        return result;
+    }
+
+    if (!fill_result_arena(result, ctx->ctx, state->state, 0, whisper_full_n_segments_from_state(state->state))) {
+        result.success = false;
+        result.error_msg = allocate_string("Out of memory");
+        return result;
+    }
+
+    result.success = true;
+    result.language = whisper_lang_str(whisper_full_lang_id_from_state(state->state));
+
+    return result;
+}
+
 whisper_bridge_context* whisper_bridge_init(whisper_bridge_params params) {
     auto* bridge_ctx = new whisper_bridge_context();
     bridge_ctx->params = params;
+    bridge_ctx->model_key = registry_key(params);
+
+    whisper_bridge_decode_params decode = whisper_bridge_decode_default_params();
+    decode.language = params.language ? params.language : "auto";
+    decode.threads = params.threads;
+    if (params.vad_threshold > 0.0f) {
+        decode.vad_threshold = params.vad_threshold;
+    }
+    bridge_ctx->decode.profile = params.profile;
+    store_decode_params(bridge_ctx, decode);
+    bridge_ctx->params.language = bridge_ctx->decode.language; // The caller's string may not outlive the context
     
-    // Initialize whisper
-    struct whisper_context_params cparams = whisper_context_default_params();
-    cparams.use_gpu = params.use_gpu;
-    
-    bridge_ctx->ctx = whisper_init_from_file_with_params(params.model_path, cparams);
+    // Load the model, or share it if another context already did
+    bridge_ctx->ctx = registry_acquire(params, bridge_ctx->model_key);
     if (!bridge_ctx->ctx) {
         delete bridge_ctx;
         return nullptr;
@@ -49,82 +406,295 @@ whisper_bridge_context* whisper_bridge_init(whisper_bridge_params params) {
 void whisper_bridge_free(whisper_bridge_context* ctx) {
     if (!ctx) return;
     
+    whisper_bridge_state_free(ctx->state);
     if (ctx->ctx) {
-        whisper_free(ctx->ctx);
+        registry_release(ctx->model_key);
     }
     delete ctx;
 }
 
+int whisper_bridge_loaded_models(void) {
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    return static_cast<int>(g_registry.size());
+}
+
+bool whisper_bridge_warmup(whisper_bridge_context* ctx, whisper_bridge_state* state, int audio_ms) {
+    if (!ctx || !ctx->ctx) return false;
+
+    if (!state) {
+        if (!ctx->state) {
+            ctx->state = whisper_bridge_state_init(ctx);
+        }
+        state = ctx->state;
+    }
+
+    // Same strategy and threads as real calls, so the same buffers get allocated
+    whisper_bridge_decode_params decode = ctx->decode;
+    decode.max_tokens = 1;
+    decode.temperature_inc = 0.0f;
+    decode.vad = false;
+
+    std::vector<float> silence(static_cast<size_t>(std::max(100, audio_ms)) * 16, 0.0f);
+    whisper_bridge_result result = transcribe_impl(ctx, state, silence.data(), static_cast<int>(silence.size()), decode, false);
+    const bool ok = result.success;
+    whisper_bridge_free_result(&result);
+    return ok;
+}
+
 whisper_bridge_result whisper_bridge_transcribe_audio(
     whisper_bridge_context* ctx,
     const float* audio_data,
     int audio_len,
     int sample_rate) {
     
-    whisper_bridge_result result = {};
+    (void)sample_rate; // Whisper always runs at 16kHz
     
-    if (!ctx || !ctx->ctx || !audio_data) {
-        result.success = false;
-        result.error_msg = allocate_string("Invalid parameters");
-        return result;
+    if (ctx && ctx->ctx && !ctx->state) {
+        ctx->state = whisper_bridge_state_init(ctx);
     }
     
-    // Set up whisper parameters
-    struct whisper_full_params wparams = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
-    wparams.language = ctx->params.language;
-    wparams.n_threads = ctx->params.threads;
-    wparams.translate = false;
-    wparams.print_progress = false;
-    wparams.print_timestamps = false;
-    
-    // Run transcription
-    int ret = whisper_full(ctx->ctx, wparams, audio_data, audio_len);
-    if (ret != 0) {
-        result.success = false;
-        result.error_msg = allocate_string("Transcription failed");
+    return whisper_bridge_transcribe_audio_with_params(ctx, audio_data, audio_len, nullptr);
+}
+
+whisper_bridge_result whisper_bridge_transcribe_audio_with_params(
+    whisper_bridge_context* ctx,
+    const float* audio_data,
+    int audio_len,
+    const whisper_bridge_decode_params* params) {
+
+    if (ctx && ctx->ctx && !ctx->state) {
+        ctx->state = whisper_bridge_state_init(ctx);
+    }
+
+    if (!ctx) {
+        whisper_bridge_result result = {};
+        result.error_msg = allocate_string("Invalid parameters");
         return result;
     }
-    
-    // Extract results
-    std::string full_text;
-    int n_segments = whisper_full_n_segments(ctx->ctx);
-    
-    for (int i = 0; i < n_segments; ++i) {
-        const char* text = whisper_full_get_segment_text(ctx->ctx, i);
-        if (text) {
-            full_text += text;
+
+    return transcribe_impl(ctx, ctx->state, audio_data, audio_len, params ? *params : ctx->decode, true);
+}
+
+const char* whisper_bridge_detect_language(
+    whisper_bridge_context* ctx,
+    whisper_bridge_state* state,
+    const float* audio_data,
+    int audio_len,
+    int threads,
+    float* probability) {
+
+    if (probability) *probability = 0.0f;
+    if (!ctx || !ctx->ctx || !audio_data || audio_len <= 0) return nullptr;
+
+    if (!whisper_is_multilingual(ctx->ctx)) {
+        if (probability) *probability = 1.0f;
+        return "en";
+    }
+
+    if (!state) {
+        if (!ctx->state) {
+            ctx->state = whisper_bridge_state_init(ctx);
         }
+        state = ctx->state;
     }
-    
-    result.success = true;
-    result.text = allocate_string(full_text);
-    result.confidence = 0.9f; // Placeholder - whisper doesn't provide confidence scores
-    result.start_time_ms = n_segments > 0 ? whisper_full_get_segment_t0(ctx->ctx, 0) * 10 : 0;
-    result.end_time_ms = n_segments > 0 ? whisper_full_get_segment_t1(ctx->ctx, n_segments - 1) * 10 : 0;
-    
-    return result;
+    if (!state || !state->state) return nullptr;
+
+    const int n_threads = threads > 0 ? threads : ctx->params.threads;
+    audio_len = std::min(audio_len, 30 * 16000); // Detection looks at one encoder window
+    if (whisper_pcm_to_mel_with_state(ctx->ctx, state->state, audio_data, audio_len, n_threads) != 0) {
+        return nullptr;
+    }
+
+    std::vector<float> probs(static_cast<size_t>(whisper_lang_max_id()) + 1, 0.0f);
+    const int lang_id = whisper_lang_auto_detect_with_state(ctx->ctx, state->state, 0, n_threads, probs.data());
+    if (lang_id < 0) return nullptr;
+
+    if (probability) *probability = probs[static_cast<size_t>(lang_id)];
+    return whisper_lang_str(lang_id);
+}
+
+whisper_bridge_decode_params whisper_bridge_decode_default_params(void) {
+    // Mirrors whisper_full_default_params
+    whisper_bridge_decode_params params = {};
+    params.strategy = WHISPER_BRIDGE_SAMPLING_GREEDY;
+    params.beam_size = 5;
+    params.best_of = 5;
+    params.temperature = 0.0f;
+    params.temperature_inc = 0.2f;
+    params.entropy_thold = 2.4f;
+    params.logprob_thold = -1.0f;
+    params.no_speech_thold = 0.6f;
+    params.max_tokens = 0;
+    params.translate = false;
+    params.suppress_nst = false;
+    params.vad = false;
+    params.vad_model_path = nullptr;
+    params.vad_threshold = 0.5f;
+    params.threads = 0;
+    params.language = nullptr;
+    params.profile = WHISPER_BRIDGE_PROFILE_DEFAULT;
+    return params;
+}
+
+whisper_bridge_decode_params whisper_bridge_get_decode_params(const whisper_bridge_context* ctx) {
+    return ctx ? ctx->decode : whisper_bridge_decode_default_params();
+}
+
+void whisper_bridge_set_decode_params(whisper_bridge_context* ctx, const whisper_bridge_decode_params* params) {
+    if (!ctx || !params) return;
+    store_decode_params(ctx, *params);
+}
+
+void whisper_bridge_set_profile(whisper_bridge_context* ctx, whisper_bridge_profile profile) {
+    if (!ctx) return;
+    ctx->decode.profile = profile;
+}
+
+whisper_bridge_profile whisper_bridge_get_profile(const whisper_bridge_context* ctx) {
+    return ctx ? ctx->decode.profile : WHISPER_BRIDGE_PROFILE_DEFAULT;
 }
 
 void whisper_bridge_free_result(whisper_bridge_result* result) {
     if (!result) return;
     
-    if (result->text) {
+    // Arena results own their text inside the arena
+    if (result->arena) {
+        free(result->arena);
+        result->arena = nullptr;
+    } else if (result->text) {
         free(result->text);
-        result->text = nullptr;
     }
+    result->text = nullptr;
+    result->segments = nullptr;
+    result->n_segments = 0;
+    result->tokens = nullptr;
+    result->n_tokens = 0;
     if (result->error_msg) {
         free(result->error_msg);
         result->error_msg = nullptr;
     }
 }
 
+whisper_bridge_state* whisper_bridge_state_init(whisper_bridge_context* ctx) {
+    if (!ctx || !ctx->ctx) return nullptr;
+
+    auto* bridge_state = new whisper_bridge_state();
+    bridge_state->state = whisper_init_state(ctx->ctx);
+    if (!bridge_state->state) {
+        delete bridge_state;
+        return nullptr;
+    }
+
+    return bridge_state;
+}
+
+void whisper_bridge_state_free(whisper_bridge_state* state) {
+    if (!state) return;
+
+    if (state->state) {
+        whisper_free_state(state->state);
+    }
+    delete state;
+}
+
+whisper_bridge_result whisper_bridge_transcribe_with_state(
+    whisper_bridge_context* ctx,
+    whisper_bridge_state* state,
+    const float* audio_data,
+    int audio_len,
+    int threads) {
+
+    if (!ctx) {
+        whisper_bridge_result result = {};
+        result.error_msg = allocate_string("Invalid parameters");
+        return result;
+    }
+
+    whisper_bridge_decode_params decode = ctx->decode;
+    if (threads > 0) {
+        decode.threads = threads;
+    }
+
+    // Segment callbacks are registered per context; pool workers sharing the context do not report them
+    return transcribe_impl(ctx, state, audio_data, audio_len, decode, false);
+}
+
+whisper_bridge_result whisper_bridge_transcribe_with_state_params(
+    whisper_bridge_context* ctx,
+    whisper_bridge_state* state,
+    const float* audio_data,
+    int audio_len,
+    const whisper_bridge_decode_params* params) {
+
+    if (!ctx) {
+        whisper_bridge_result result = {};
+        result.error_msg = allocate_string("Invalid parameters");
+        return result;
+    }
+
+    return transcribe_impl(ctx, state, audio_data, audio_len, params ? *params : ctx->decode, false);
+}
+
+void whisper_bridge_set_segment_callback(
+    whisper_bridge_context* ctx,
+    whisper_bridge_segment_callback callback,
+    void* user_data) {
+
+    if (!ctx) return;
+    ctx->segment_callback = callback;
+    ctx->segment_user_data = user_data;
+}
+
+void whisper_bridge_set_progress_callback(
+    whisper_bridge_context* ctx,
+    whisper_bridge_progress_callback callback,
+    void* user_data) {
+
+    if (!ctx) return;
+    ctx->progress_callback = callback;
+    ctx->progress_user_data = user_data;
+}
+
+whisper_bridge_stream_params whisper_bridge_stream_default_params(void) {
+    whisper_bridge_stream_params params;
+    params.step_ms = 500;
+    params.length_ms = 5000;
+    params.keep_ms = 200;
+    params.max_prompt_tokens = 128;
+    return params;
+}
+
 bool whisper_bridge_start_stream(
     whisper_bridge_context* ctx, 
     whisper_bridge_callback callback,
     void* user_data) {
     
-    if (!ctx || !callback) return false;
-    
+    return whisper_bridge_start_stream_with_params(ctx, whisper_bridge_stream_default_params(), callback, user_data);
+}
+
+bool whisper_bridge_start_stream_with_params(
+    whisper_bridge_context* ctx,
+    whisper_bridge_stream_params params,
+    whisper_bridge_callback callback,
+    void* user_data) {
+
+    if (!ctx || !ctx->ctx || !callback) return false;
+
+    if (!ctx->state) {
+        ctx->state = whisper_bridge_state_init(ctx);
+        if (!ctx->state) return false;
+    }
+
+    // Sanitize: the window must hold at least one step plus the overlap
+    params.step_ms = std::max(100, params.step_ms);
+    params.keep_ms = std::max(0, params.keep_ms);
+    params.length_ms = std::max(params.length_ms, params.step_ms + params.keep_ms);
+    params.max_prompt_tokens = std::max(0, params.max_prompt_tokens);
+
+    ctx->stream = whisper_bridge_stream();
+    ctx->stream.params = params;
+    ctx->stream.window.reserve(static_cast<size_t>(params.length_ms) * 16);
+
     ctx->callback = callback;
     ctx->user_data = user_data;
     ctx->streaming = true;
@@ -132,23 +702,156 @@ bool whisper_bridge_start_stream(
     return true;
 }
 
+namespace {
+    // Number of leading hypothesis tokens that repeat the end of the committed text.
+    // The overlap may start mid-word, so the match may begin up to two tokens in.
+    size_t overlap_tokens(const std::vector<whisper_token>& tail, const std::vector<whisper_token>& hyp) {
+        size_t best = 0;
+        for (size_t skip = 0; skip <= 2 && skip < hyp.size(); ++skip) {
+            const size_t max_k = std::min(tail.size(), hyp.size() - skip);
+            for (size_t k = max_k; k > 0; --k) {
+                // A single-token match only counts at the very start; otherwise it is likely a common word
+                if (skip > 0 && k < 2) break;
+                if (std::equal(tail.end() - k, tail.end(), hyp.begin() + skip)) {
+                    best = std::max(best, skip + k);
+                    break;
+                }
+            }
+        }
+        return best;
+    }
+
+    void stream_decode(whisper_bridge_context* ctx, bool final) {
+        whisper_bridge_stream& stream = ctx->stream;
+        stream.new_samples = 0;
+        if (stream.window.size() <= stream.keep_samples) return;
+
+        struct whisper_full_params wparams = build_wparams(ctx, ctx->decode);
+        wparams.no_context = true; // Context comes from prompt_tokens, not the state's previous run
+        wparams.single_segment = true;
+        wparams.prompt_tokens = stream.prompt.empty() ? nullptr : stream.prompt.data();
+        wparams.prompt_n_tokens = static_cast<int>(stream.prompt.size());
+        apply_profile(wparams, ctx->decode.profile, static_cast<int>(stream.window.size()));
+
+        whisper_bridge_result result = {};
+        int ret = whisper_full_with_state(ctx->ctx, ctx->state->state, wparams,
+                                          stream.window.data(), static_cast<int>(stream.window.size()));
+        if (ret != 0) {
+            result.success = false;
+            result.error_msg = allocate_string("Transcription failed");
+            ctx->callback(&result, ctx->user_data);
+            whisper_bridge_free_result(&result);
+            return;
+        }
+
+        // Text tokens of the hypothesis (special tokens sort after end-of-text)
+        const whisper_token eot = whisper_token_eot(ctx->ctx);
+        std::vector<whisper_token> ids;
+        std::vector<std::string> pieces;
+        std::vector<float> probs;
+        const int n_segments = whisper_full_n_segments_from_state(ctx->state->state);
+        for (int i = 0; i < n_segments; ++i) {
+            const int n_tokens = whisper_full_n_tokens_from_state(ctx->state->state, i);
+            for (int j = 0; j < n_tokens; ++j) {
+                const whisper_token id = whisper_full_get_token_id_from_state(ctx->state->state, i, j);
+                if (!is_text_token(id, eot)) continue;
+                const char* piece = whisper_full_get_token_text_from_state(ctx->ctx, ctx->state->state, i, j);
+                ids.push_back(id);
+                pieces.push_back(piece ? piece : "");
+                probs.push_back(whisper_full_get_token_p_from_state(ctx->state->state, i, j));
+            }
+        }
+
+        // Drop words already committed from the overlapping audio
+        const size_t skip = stream.keep_samples > 0 ? overlap_tokens(stream.committed_tail, ids) : 0;
+
+        std::string text;
+        float p_sum = 0.0f;
+        for (size_t k = skip; k < ids.size(); ++k) {
+            text += pieces[k];
+            p_sum += probs[k];
+        }
+
+        if (!text.empty()) {
+            result.success = true;
+            result.is_partial = !final;
+            result.text = allocate_string(text);
+            result.confidence = ids.size() > skip ? p_sum / static_cast<float>(ids.size() - skip) : 0.0f;
+            result.start_time_ms = static_cast<int64_t>(stream.window_start * 1000.0 + stream.keep_samples / 16);
+            result.end_time_ms = static_cast<int64_t>(stream.window_start * 1000.0 + stream.window.size() / 16);
+            result.language = whisper_lang_str(whisper_full_lang_id_from_state(ctx->state->state));
+            ctx->callback(&result, ctx->user_data);
+            whisper_bridge_free_result(&result);
+        }
+
+        if (!final) return;
+
+        // Commit: the new tokens extend the prompt and become the alignment reference
+        if (ids.size() > skip) {
+            stream.prompt.insert(stream.prompt.end(), ids.begin() + skip, ids.end());
+            const size_t max_prompt = static_cast<size_t>(stream.params.max_prompt_tokens);
+            if (stream.prompt.size() > max_prompt) {
+                stream.prompt.erase(stream.prompt.begin(), stream.prompt.end() - max_prompt);
+            }
+            stream.committed_tail.assign(ids.begin() + skip, ids.end());
+        }
+
+        // Slide: keep the tail of the window for the words straddling the boundary
+        const size_t keep = std::min(stream.window.size(), static_cast<size_t>(stream.params.keep_ms) * 16);
+        const size_t drop = stream.window.size() - keep;
+        stream.window.erase(stream.window.begin(), stream.window.begin() + drop);
+        stream.window_start += drop / 16000.0;
+        stream.keep_samples = keep;
+    }
+}
+
 void whisper_bridge_add_audio(
     whisper_bridge_context* ctx,
     const float* audio_data,
     int audio_len,
     double timestamp) {
     
-    if (!ctx || !ctx->streaming || !audio_data) return;
-    
-    // For now, process each audio chunk immediately
-    // In a real implementation, you'd buffer audio and process in chunks
-    whisper_bridge_result result = whisper_bridge_transcribe_audio(ctx, audio_data, audio_len, 16000);
-    
-    if (ctx->callback && result.success && result.text && strlen(result.text) > 0) {
-        ctx->callback(&result, ctx->user_data);
+    if (!ctx || !ctx->streaming || !audio_data || audio_len <= 0) return;
+
+    whisper_bridge_stream& stream = ctx->stream;
+    if (!stream.anchored) {
+        stream.window_start = timestamp;
+        stream.anchored = true;
     }
-    
-    whisper_bridge_free_result(&result);
+
+    const size_t step_samples = static_cast<size_t>(stream.params.step_ms) * 16;
+    const size_t length_samples = static_cast<size_t>(stream.params.length_ms) * 16;
+
+    // Feed in slices so that a large chunk still yields a decode per step and never overfills the window
+    size_t remaining = static_cast<size_t>(audio_len);
+    while (remaining > 0) {
+        const size_t take = std::min(remaining, std::min(length_samples - stream.window.size(),
+                                                         step_samples - stream.new_samples));
+        stream.window.insert(stream.window.end(), audio_data, audio_data + take);
+        stream.new_samples += take;
+        audio_data += take;
+        remaining -= take;
+
+        if (stream.window.size() >= length_samples) {
+            stream_decode(ctx, true);
+        } else if (stream.new_samples >= step_samples) {
+            stream_decode(ctx, false);
+        }
+    }
+}
+
+void whisper_bridge_flush_stream(whisper_bridge_context* ctx) {
+    if (!ctx || !ctx->streaming) return;
+
+    stream_decode(ctx, true);
+
+    // No audio carries over into the next utterance, so there is nothing to align against
+    whisper_bridge_stream& stream = ctx->stream;
+    stream.window.clear();
+    stream.keep_samples = 0;
+    stream.new_samples = 0;
+    stream.anchored = false;
+    stream.committed_tail.clear();
 }
 
 void whisper_bridge_stop_stream(whisper_bridge_context* ctx) {
@@ -157,4 +860,5 @@ void whisper_bridge_stop_stream(whisper_bridge_context* ctx) {
     ctx->streaming = false;
     ctx->callback = nullptr;
     ctx->user_data = nullptr;
+    ctx->stream = whisper_bridge_stream();
 }
\ No newline at end of file
@@ -3,20 +3,139 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstring>
+#include <deque>
 #include <thread>
 
+#if defined(__APPLE__)
+#include <pthread.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    /**
+     * @brief Run the calling thread behind interactive work (final decodes yield to live partials)
+     */
+    void lowerThreadPriority()
+    {
+#if defined(__APPLE__)
+        pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#elif defined(__linux__)
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+    }
+
+    /**
+     * @brief Per-worker segment queue for offline transcription
+     *
+     * The owner takes from the front; idle workers steal from the back.
+     */
+    struct SegmentQueue
+    {
+        std::mutex mutex;
+        std::deque<size_t> items;
+    };
+
+    bool takeSegment(std::vector<SegmentQueue> &queues, size_t self, size_t &index)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queues[self].mutex);
+            if (!queues[self].items.empty())
+            {
+                index = queues[self].items.front();
+                queues[self].items.pop_front();
+                return true;
+            }
+        }
+
+        for (size_t k = 1; k < queues.size(); k++)
+        {
+            SegmentQueue &victim = queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.items.empty())
+            {
+                index = victim.items.back();
+                victim.items.pop_back();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Whether a final segment is worth a beam-search second pass
+     */
+    bool isLowConfidence(const WhisperTranscriber::Result &result, float confidenceThreshold, float logprobThreshold)
+    {
+        if (result.confidence < confidenceThreshold)
+        {
+            return true;
+        }
+        if (result.tokens.empty())
+        {
+            return false;
+        }
+
+        float sum = 0.0f;
+        for (const auto &token : result.tokens)
+        {
+            sum += token.logProbability;
+        }
+        return sum / result.tokens.size() < logprobThreshold;
+    }
+}
+
 WhisperTranscriber::WhisperTranscriber(const Config &config)
-    : config_(config), whisperContext_(nullptr), initialized_(false), shouldStop_(false), bufferStartTime_(0.0)
+    : config_(config), whisperContext_(nullptr), fallbackContext_(nullptr), activeContext_(nullptr), initialized_(false),
+      shouldStop_(false), pendingSamples_(0), queuedSamples_(0), queueGap_(false), overloaded_(false), policyActive_(false),
+      coalescing_(false), governorLevel_(0), streamAudioSeconds_(0.0), streamDecodeSeconds_(0.0), partialContext_(nullptr),
+      streamContext_(nullptr), cascade_(false), utteranceId_(0), finalStop_(false), finalParamsDirty_(false), loadMs_(0.0),
+      warmupMs_(0.0), firstResultMs_(-1.0),
+      refineStop_(false), refineState_(nullptr), refineParams_(whisper_bridge_decode_default_params()), languageState_(nullptr), languageProbeTarget_(0),
+      languageProbing_(false), languageDetectionFailed_(false), samplesSincePin_(0), languageDirty_(false), bufferStartTime_(0.0),
+      segmentOffset_(0.0), segmentsReported_(0)
 {
-    // Initialize audio buffer
-    const size_t bufferSamples = BUFFER_SIZE_SECONDS * 16000; // 16kHz * seconds
+    // Initialize audio buffer, with room for the chunk that crosses the limit so it never reallocates
+    // (a coalesced buffer grows to maxSegmentLength)
+    const size_t bufferSeconds = std::max<size_t>(BUFFER_SIZE_SECONDS, static_cast<size_t>(std::max(0, config_.maxSegmentLength)));
+    const size_t bufferSamples = (bufferSeconds + 1) * 16000; // 16kHz * seconds
     audioBuffer_.reserve(bufferSamples);
+    chunkPool_ = std::make_unique<AudioChunkPool>(16000 / 50); // 20 ms
 }
 
 WhisperTranscriber::~WhisperTranscriber()
 {
     stopRealTimeProcessing();
 
+    if (languageState_)
+    {
+        whisper_bridge_state_free(languageState_);
+        languageState_ = nullptr;
+    }
+
+    if (refineState_)
+    {
+        whisper_bridge_state_free(refineState_);
+        refineState_ = nullptr;
+    }
+
+    if (partialContext_)
+    {
+        whisper_bridge_free(partialContext_);
+        partialContext_ = nullptr;
+    }
+
+    if (fallbackContext_)
+    {
+        whisper_bridge_free(fallbackContext_);
+        fallbackContext_ = nullptr;
+    }
+
     if (whisperContext_)
     {
         whisper_bridge_free(whisperContext_);
@@ -32,6 +151,7 @@ bool WhisperTranscriber::initialize()
     }
 
     std::cout << "Loading Whisper model: " << config_.modelPath << std::endl;
+    const auto loadStart = std::chrono::steady_clock::now();
 
     // Initialize whisper bridge parameters
     whisper_bridge_params params = {};
@@ -39,8 +159,10 @@ bool WhisperTranscriber::initialize()
     params.language = config_.language.c_str();
     params.threads = config_.threads;
     params.max_len_ms = config_.maxSegmentLength * 1000;
-    params.vad_threshold = config_.silenceThreshold;
+    params.vad_threshold = config_.whisperVadThreshold;
     params.use_gpu = false; // Use CPU for compatibility
+    params.profile = config_.lowLatency ? WHISPER_BRIDGE_PROFILE_LOW_LATENCY : WHISPER_BRIDGE_PROFILE_DEFAULT;
+    params.prefault = config_.prefaultModel;
 
     // Initialize the bridge
     whisperContext_ = whisper_bridge_init(params);
@@ -51,28 +173,108 @@ bool WhisperTranscriber::initialize()
         return false;
     }
 
+    // Optional smaller model for the governor; failing to load it only disables that step
+    if (!config_.fallbackModelPath.empty())
+    {
+        params.model_path = config_.fallbackModelPath.c_str();
+        fallbackContext_ = whisper_bridge_init(params);
+        if (!fallbackContext_)
+        {
+            std::cerr << "Failed to load fallback Whisper model: " << config_.fallbackModelPath << std::endl;
+        }
+    }
+
+    // Cascade: the partial model always runs with an encoder context sized to the window
+    if (!config_.partialModelPath.empty())
+    {
+        params.model_path = config_.partialModelPath.c_str();
+        params.profile = WHISPER_BRIDGE_PROFILE_LOW_LATENCY;
+        partialContext_ = whisper_bridge_init(params);
+        if (!partialContext_)
+        {
+            std::cerr << "Failed to load partial Whisper model: " << config_.partialModelPath << std::endl;
+        }
+    }
+    activeContext_ = whisperContext_;
+    streamContext_ = whisperContext_;
+    loadMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+
+    // Degradation ladder, cheapest loss of accuracy first; steps that would change nothing are left out.
+    // A cascade's final model decodes on its own thread, so its parameters are never changed under it
+    governorLadder_.clear();
+    if (config_.rtfGovernor && !partialContext_)
+    {
+        if (config_.beamSearch || config_.temperatureIncrement > 0.0f)
+        {
+            governorLadder_.push_back(GovernorStep::ReduceBeam);
+        }
+        if (!config_.lowLatency)
+        {
+            governorLadder_.push_back(GovernorStep::TruncateContext);
+        }
+        if (fallbackContext_ && !config_.streaming)
+        {
+            governorLadder_.push_back(GovernorStep::SmallerModel);
+        }
+    }
+
+    // Without a ladder the governor only measures the real-time factor
+    RtfGovernor::Config governorConfig;
+    governorConfig.maxLevel = static_cast<int>(governorLadder_.size());
+    governor_ = std::make_unique<RtfGovernor>(governorConfig);
+    governorLevel_ = 0;
+
     initialized_ = true;
+    applyDecodeParams();
+
+    // The first live decode would otherwise allocate compute buffers and fault in the weights.
+    // The fallback model is left cold: it only runs once the host is already behind
+    if (config_.warmup)
+    {
+        const auto warmupStart = std::chrono::steady_clock::now();
+        if (!whisper_bridge_warmup(whisperContext_, nullptr, 1000))
+        {
+            std::cerr << "Whisper warm-up decode failed" << std::endl;
+        }
+        if (partialContext_ && !whisper_bridge_warmup(partialContext_, nullptr, 1000))
+        {
+            std::cerr << "Whisper warm-up decode failed for " << config_.partialModelPath << std::endl;
+        }
+        warmupMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - warmupStart).count();
+    }
 
     // Print system info if in debug mode
     printSystemInfo();
 
-    std::cout << "Whisper model loaded successfully!" << std::endl;
+    std::cout << "Whisper model loaded successfully! (load " << static_cast<int>(loadMs_) << " ms, warm-up "
+              << static_cast<int>(warmupMs_) << " ms)" << std::endl;
 
     return true;
 }
 
 std::vector<WhisperTranscriber::Result> WhisperTranscriber::transcribe(const std::vector<float> &audioData)
 {
-    if (!initialized_ || audioData.empty())
+    return transcribe(audioData.data(), audioData.size());
+}
+
+std::vector<WhisperTranscriber::Result> WhisperTranscriber::transcribe(const float *samples, size_t count)
+{
+    return transcribeWithContext(whisperContext_, samples, count);
+}
+
+std::vector<WhisperTranscriber::Result> WhisperTranscriber::transcribeWithContext(whisper_bridge_context *context,
+                                                                                const float *samples, size_t count)
+{
+    if (!initialized_ || !samples || count == 0)
     {
         return {};
     }
 
     // Use the bridge API for transcription
     whisper_bridge_result result = whisper_bridge_transcribe_audio(
-        whisperContext_, 
-        audioData.data(), 
-        audioData.size(), 
+        context, 
+        samples, 
+        static_cast<int>(count), 
         16000  // sample rate
     );
 
@@ -90,6 +292,188 @@ std::vector<WhisperTranscriber::Result> WhisperTranscriber::transcribe(const std
     return results;
 }
 
+std::vector<WhisperTranscriber::Result> WhisperTranscriber::transcribeOffline(const std::vector<float> &audioData,
+                                                                            std::function<void(size_t, size_t)> progress)
+{
+    if (!initialized_ || audioData.empty())
+    {
+        return {};
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    const size_t maxSamples = static_cast<size_t>(std::max(1, config_.maxSegmentLength)) * 16000;
+    const auto segments = splitAtSilence(audioData, maxSamples);
+    if (segments.empty())
+    {
+        return {};
+    }
+
+    const int threadsPerWorker = std::max(1, config_.offlineThreadsPerWorker);
+    size_t workers = config_.offlineWorkers > 0
+                         ? static_cast<size_t>(config_.offlineWorkers)
+                         : std::max(1u, std::thread::hardware_concurrency() / threadsPerWorker);
+    workers = std::min(workers, segments.size());
+
+    // One decoding state per worker; all of them share the loaded model weights
+    std::vector<whisper_bridge_state *> states;
+    for (size_t i = 0; i < workers; i++)
+    {
+        whisper_bridge_state *state = whisper_bridge_state_init(whisperContext_);
+        if (!state)
+        {
+            break;
+        }
+        states.push_back(state);
+    }
+
+    if (states.empty())
+    {
+        std::cerr << "Failed to create Whisper decoding state" << std::endl;
+        return {};
+    }
+    if (states.size() < workers)
+    {
+        std::cerr << "Only " << states.size() << " of " << workers << " Whisper states could be created" << std::endl;
+    }
+    workers = states.size();
+
+    std::cout << "Offline transcription: " << segments.size() << " segments on " << workers << " workers x "
+              << threadsPerWorker << " threads" << std::endl;
+
+    // Deal contiguous runs of segments to each worker; the stealing evens out uneven segment costs
+    std::vector<SegmentQueue> queues(workers);
+    for (size_t i = 0; i < segments.size(); i++)
+    {
+        queues[i * workers / segments.size()].items.push_back(i);
+    }
+
+    std::vector<std::vector<Result>> segmentResults(segments.size());
+    std::atomic<size_t> completed(0);
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+
+    for (size_t w = 0; w < workers; w++)
+    {
+        pool.emplace_back([&, w]()
+                          {
+            size_t index = 0;
+            while (takeSegment(queues, w, index))
+            {
+                const size_t begin = segments[index].first;
+                const size_t end = segments[index].second;
+
+                whisper_bridge_result result = whisper_bridge_transcribe_with_state(
+                    whisperContext_, states[w], audioData.data() + begin, static_cast<int>(end - begin), threadsPerWorker);
+
+                if (result.success)
+                {
+                    auto results = extractResults(result);
+                    const double offset = static_cast<double>(begin) / 16000.0;
+                    for (auto &r : results)
+                    {
+                        offsetTimes(r, offset);
+                    }
+                    segmentResults[index] = std::move(results);
+                }
+                else
+                {
+                    std::cerr << "Failed to transcribe segment at " << begin / 16000.0 << "s: "
+                              << (result.error_msg ? result.error_msg : "Unknown error") << std::endl;
+                }
+                whisper_bridge_free_result(&result);
+
+                const size_t done = completed.fetch_add(1) + 1;
+                if (progress)
+                {
+                    progress(done, segments.size());
+                }
+            } });
+    }
+
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+
+    for (whisper_bridge_state *state : states)
+    {
+        whisper_bridge_state_free(state);
+    }
+
+    // Segments are in timestamp order, so stitching is a concatenation
+    std::vector<Result> results;
+    for (auto &segment : segmentResults)
+    {
+        results.insert(results.end(), std::make_move_iterator(segment.begin()), std::make_move_iterator(segment.end()));
+    }
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    const double duration = static_cast<double>(audioData.size()) / 16000.0;
+    std::cout << "Offline transcription: " << duration << "s of audio in " << elapsed << "s (RTF "
+              << (duration > 0.0 ? elapsed / duration : 0.0) << ")" << std::endl;
+
+    return results;
+}
+
+std::vector<std::pair<size_t, size_t>> WhisperTranscriber::splitAtSilence(const std::vector<float> &audioData, size_t maxSamples) const
+{
+    constexpr size_t FRAME_SAMPLES = 320; // 20 ms at 16kHz
+
+    // Mean energy per frame, for the quietest-frame fallback
+    const size_t frameCount = (audioData.size() + FRAME_SAMPLES - 1) / FRAME_SAMPLES;
+    std::vector<float> energy(frameCount, 0.0f);
+    for (size_t f = 0; f < frameCount; f++)
+    {
+        const size_t begin = f * FRAME_SAMPLES;
+        const size_t count = std::min(audioData.size() - begin, FRAME_SAMPLES);
+        float zeroCrossingRate = 0.0f;
+        VoiceActivityDetector::frameFeatures(audioData.data() + begin, count, energy[f], zeroCrossingRate);
+    }
+
+    // Frames the VAD emits (pre-roll, speech and hangover) count as speech
+    std::vector<uint8_t> speech(frameCount, 0);
+    VoiceActivityDetector vad(buildVadConfig());
+    vad.setCallbacks(
+        [&speech, frameCount](const float *, size_t count, double timestamp)
+        {
+            const size_t first = static_cast<size_t>(std::llround(timestamp * 16000.0));
+            const size_t begin = std::min(frameCount, first / FRAME_SAMPLES);
+            const size_t end = std::min(frameCount, (first + count + FRAME_SAMPLES - 1) / FRAME_SAMPLES);
+            std::fill(speech.begin() + begin, speech.begin() + end, 1);
+        },
+        nullptr);
+    vad.process(audioData.data(), audioData.size(), 0.0);
+    vad.flush();
+
+    const size_t maxFrames = std::max<size_t>(1, maxSamples / FRAME_SAMPLES);
+    const size_t minFrames = maxFrames / 2;
+
+    std::vector<std::pair<size_t, size_t>> segments;
+    size_t begin = 0;
+    while (begin < frameCount)
+    {
+        size_t end = std::min(frameCount, begin + maxFrames);
+
+        if (end < frameCount)
+        {
+            // Cut at a pause in the second half of the window
+            end = std::max(VoiceActivityDetector::findPause(energy, speech, begin + minFrames, end), begin + 1);
+        }
+
+        const bool hasSpeech = std::any_of(speech.begin() + begin, speech.begin() + end,
+                                           [](uint8_t s)
+                                           { return s != 0; });
+        if (hasSpeech)
+        {
+            segments.emplace_back(begin * FRAME_SAMPLES, std::min(audioData.size(), end * FRAME_SAMPLES));
+        }
+
+        begin = end;
+    }
+
+    return segments;
+}
+
 void WhisperTranscriber::addAudioData(const std::vector<float> &audioData, double timestamp)
 {
     if (!initialized_ || audioData.empty())
@@ -97,11 +481,86 @@ void WhisperTranscriber::addAudioData(const std::vector<float> &audioData, doubl
         return;
     }
 
+    addAudioData(chunkPool_->copyOf(audioData.data(), audioData.size(), timestamp));
+}
+
+void WhisperTranscriber::addAudioData(const AudioChunkHandle &chunk)
+{
+    if (!initialized_ || !chunk || chunk->size() == 0)
+    {
+        return;
+    }
+
+    const size_t samples = chunk->size();
     std::lock_guard<std::mutex> lock(queueMutex_);
-    audioQueue_.push(std::make_pair(audioData, timestamp));
+    audioQueue_.push(chunk);
+    queuedSamples_ += samples;
+    pendingSamples_.fetch_add(samples);
+    enforceQueueBound();
     queueCondition_.notify_one();
 }
 
+void WhisperTranscriber::enforceQueueBound()
+{
+    const size_t maxSamples = static_cast<size_t>(std::max(0, config_.maxQueueMs)) * 16;
+
+    uint64_t droppedChunks = 0;
+    uint64_t droppedSamples = 0;
+    bool crossed = false;
+
+    if (maxSamples > 0)
+    {
+        // Keep the newest chunk so a single oversized chunk is still transcribed
+        AudioChunkHandle oldest;
+        while (queuedSamples_ > maxSamples && audioQueue_.size() > 1 && audioQueue_.pop(oldest))
+        {
+            const size_t count = oldest->size();
+            queuedSamples_ -= std::min(queuedSamples_, count);
+            releasePendingSamples(count);
+            droppedChunks++;
+            droppedSamples += count;
+            oldest.reset();
+        }
+
+        if (droppedChunks > 0)
+        {
+            queueGap_ = true;
+        }
+
+        if (!overloaded_.load() && queuedSamples_ > maxSamples / 2)
+        {
+            overloaded_.store(true);
+            crossed = true;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.peakQueuedSamples = std::max(stats_.peakQueuedSamples, queuedSamples_);
+    stats_.droppedChunks += droppedChunks;
+    stats_.droppedSamples += droppedSamples;
+    stats_.overloadEvents += crossed ? 1 : 0;
+}
+
+void WhisperTranscriber::releasePendingSamples(size_t count)
+{
+    size_t pending = pendingSamples_.load();
+    while (!pendingSamples_.compare_exchange_weak(pending, pending - std::min(pending, count)))
+    {
+        // pending now holds the current value; clamp against that
+    }
+}
+
+size_t WhisperTranscriber::getPendingSamples() const
+{
+    return pendingSamples_.load();
+}
+
+WhisperTranscriber::OverloadStats WhisperTranscriber::getOverloadStats() const
+{
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return stats_;
+}
+
 void WhisperTranscriber::startRealTimeProcessing(std::function<void(const Result &)> callback)
 {
     if (processingThread_.joinable())
@@ -111,6 +570,121 @@ void WhisperTranscriber::startRealTimeProcessing(std::function<void(const Result
 
     resultCallback_ = callback;
     shouldStop_.store(false);
+    sessionStart_ = std::chrono::steady_clock::now();
+    firstResultMs_.store(-1.0);
+
+    cascade_ = partialContext_ && config_.enableVAD;
+    if (partialContext_ && !config_.enableVAD)
+    {
+        std::cerr << "The partial model needs enableVAD to close utterances; using " << config_.modelPath << " only" << std::endl;
+    }
+    streamContext_ = cascade_ ? partialContext_ : whisperContext_;
+    utteranceId_ = 0;
+    draft_.clear();
+
+    // Each session detects its own language
+    {
+        std::lock_guard<std::mutex> lock(languageMutex_);
+        pinnedLanguage_.clear();
+    }
+    languageProbe_.clear();
+    languageProbing_ = false;
+    languageDetectionFailed_ = false;
+    samplesSincePin_ = 0;
+    applyDecodeParams();
+
+    // Every session starts undegraded
+    overloaded_.store(false);
+    policyActive_ = false;
+    coalescing_ = false;
+    streamAudioSeconds_ = 0.0;
+    streamDecodeSeconds_ = 0.0;
+    if (governor_)
+    {
+        governor_->reset();
+        applyGovernorLevel(0);
+    }
+
+    if (config_.streaming || cascade_)
+    {
+        whisper_bridge_stream_params streamParams = whisper_bridge_stream_default_params();
+        streamParams.step_ms = config_.streamStepMs;
+        streamParams.length_ms = config_.streamLengthMs;
+        streamParams.keep_ms = config_.streamKeepMs;
+
+        if (!whisper_bridge_start_stream_with_params(streamContext_, streamParams, &WhisperTranscriber::onStreamResult, this))
+        {
+            std::cerr << "Failed to start streaming decode; falling back to buffered transcription" << std::endl;
+            config_.streaming = false;
+            cascade_ = false;
+            streamContext_ = whisperContext_;
+        }
+    }
+
+    if (cascade_)
+    {
+        finalStop_ = false;
+        finalThread_ = std::thread(&WhisperTranscriber::finalThreadFunction, this);
+    }
+
+    // Each session has its own transcript; low-confidence finals are decoded again in the background
+    {
+        std::lock_guard<std::mutex> lock(transcriptMutex_);
+        transcript_.clear();
+        refineStats_ = RefinementStats();
+    }
+    if (config_.refineLowConfidence)
+    {
+        if (!refineState_)
+        {
+            refineState_ = whisper_bridge_state_init(whisperContext_);
+        }
+
+        if (refineState_)
+        {
+            // Session-wide settings; the language is read per job since it may be pinned later
+            refineParams_ = buildDecodeParams(config_.language);
+            refineParams_.strategy = WHISPER_BRIDGE_SAMPLING_BEAM_SEARCH;
+            refineParams_.beam_size = std::max(2, config_.refineBeamSize);
+            refineParams_.threads = std::max(1, config_.threads / 2);
+            refineParams_.language = nullptr;
+            refineParams_.profile = WHISPER_BRIDGE_PROFILE_DEFAULT; // Accuracy pass; never the governor's low-latency profile
+            refineStop_ = false;
+            refineThread_ = std::thread(&WhisperTranscriber::refineThreadFunction, this);
+        }
+        else
+        {
+            std::cerr << "Failed to create the refinement state; low-confidence segments are not re-decoded" << std::endl;
+        }
+    }
+
+    vad_.reset();
+    if (config_.enableVAD)
+    {
+        vad_ = std::make_unique<VoiceActivityDetector>(buildVadConfig());
+        vad_->setCallbacks(
+            [this](const float *samples, size_t count, double timestamp)
+            {
+                appendToBuffer(samples, count, timestamp);
+            },
+            [this](double)
+            {
+                // Utterance over: transcribe it as one unit
+                if (cascade_)
+                {
+                    whisper_bridge_flush_stream(streamContext_);
+                    submitFinal();
+                }
+                else if (config_.streaming)
+                {
+                    whisper_bridge_flush_stream(streamContext_);
+                }
+                else
+                {
+                    processBuffer();
+                }
+            });
+    }
 
     processingThread_ = std::thread(&WhisperTranscriber::processingThreadFunction, this);
 
@@ -132,13 +706,47 @@ void WhisperTranscriber::stopRealTimeProcessing()
         processingThread_.join();
     }
 
-    // Clear remaining data
-    std::lock_guard<std::mutex> lock(queueMutex_);
-    while (!audioQueue_.empty())
+    // Only the processing thread detects the language
+    if (languageState_)
+    {
+        whisper_bridge_state_free(languageState_);
+        languageState_ = nullptr;
+    }
+
+    if (config_.streaming || cascade_)
+    {
+        whisper_bridge_stop_stream(streamContext_);
+    }
+
+    // Utterances closed before the stop still get their final decode
+    if (finalThread_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(finalMutex_);
+            finalStop_ = true;
+        }
+        finalCondition_.notify_all();
+        finalThread_.join();
+    }
+
+    // Segments already queued are still refined so the transcript is complete on return
+    if (refineThread_.joinable())
     {
-        audioQueue_.pop();
+        {
+            std::lock_guard<std::mutex> lock(refineMutex_);
+            refineStop_ = true;
+        }
+        refineCondition_.notify_all();
+        refineThread_.join();
     }
+
+    // Clear remaining data
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    audioQueue_.clear();
     audioBuffer_.clear();
+    pendingSamples_.store(0);
+    queuedSamples_ = 0;
+    queueGap_ = false;
 
     std::cout << "Real-time processing stopped" << std::endl;
 }
@@ -163,12 +771,354 @@ std::vector<std::string> WhisperTranscriber::getSupportedLanguages()
 
 void WhisperTranscriber::setLanguage(const std::string &language)
 {
-    config_.language = language;
+    {
+        std::lock_guard<std::mutex> lock(languageMutex_);
+        pendingLanguage_ = language;
+    }
+    languageDirty_.store(true);
+
+    // During a session the processing thread owns the decode parameters and applies it before its next decode
+    if (!processingThread_.joinable())
+    {
+        applyPendingLanguage();
+    }
 }
 
-void WhisperTranscriber::processingThreadFunction()
+void WhisperTranscriber::applyPendingLanguage()
 {
-    std::cout << "Processing thread started" << std::endl;
+    if (!languageDirty_.exchange(false))
+    {
+        return;
+    }
+
+    {
+        // An explicit language replaces the pin; "auto" starts detection again
+        std::lock_guard<std::mutex> lock(languageMutex_);
+        config_.language = pendingLanguage_;
+        pinnedLanguage_.clear();
+    }
+    languageProbe_.clear();
+    languageProbing_ = false;
+    languageDetectionFailed_ = false;
+    samplesSincePin_ = 0;
+
+    if (whisperContext_)
+    {
+        applyDecodeParams();
+    }
+}
+
+std::string WhisperTranscriber::getSessionLanguage() const
+{
+    std::lock_guard<std::mutex> lock(languageMutex_);
+    return pinnedLanguage_;
+}
+
+std::string WhisperTranscriber::decodeLanguage() const
+{
+    std::lock_guard<std::mutex> lock(languageMutex_);
+    return pinnedLanguage_.empty() ? config_.language : pinnedLanguage_;
+}
+
+VoiceActivityDetector::Config WhisperTranscriber::buildVadConfig() const
+{
+    VoiceActivityDetector::Config vadConfig;
+    vadConfig.frameMs = config_.vadFrameMs;
+    vadConfig.hangoverMs = config_.vadHangoverMs;
+    vadConfig.preRollMs = config_.vadPreRollMs;
+    vadConfig.minEnergy = config_.silenceThreshold * config_.silenceThreshold;
+    return vadConfig;
+}
+
+whisper_bridge_decode_params WhisperTranscriber::buildDecodeParams(const std::string &language) const
+{
+    whisper_bridge_decode_params params = whisper_bridge_decode_default_params();
+    params.strategy = config_.beamSearch ? WHISPER_BRIDGE_SAMPLING_BEAM_SEARCH : WHISPER_BRIDGE_SAMPLING_GREEDY;
+    params.beam_size = config_.beamSize;
+    params.best_of = config_.bestOf;
+    params.temperature_inc = config_.temperatureIncrement;
+    params.entropy_thold = config_.entropyThreshold;
+    params.logprob_thold = config_.logprobThreshold;
+    params.no_speech_thold = config_.noSpeechThreshold;
+    params.max_tokens = config_.maxTokensPerSegment;
+    params.translate = config_.translate;
+    params.suppress_nst = config_.suppressNonSpeech;
+    params.vad = !config_.whisperVadModel.empty();
+    params.vad_model_path = config_.whisperVadModel.c_str();
+    params.vad_threshold = config_.whisperVadThreshold;
+    params.threads = config_.threads;
+    params.language = language.c_str();
+
+    if (governorStepActive(GovernorStep::ReduceBeam))
+    {
+        params.strategy = WHISPER_BRIDGE_SAMPLING_GREEDY;
+        params.best_of = 1;
+        params.temperature_inc = 0.0f;
+    }
+
+    // Finals run beside the partial stream, so they get a share of the cores
+    if (partialContext_)
+    {
+        params.threads = config_.finalThreads > 0 ? config_.finalThreads : std::max(1, config_.threads / 2);
+    }
+
+    return params;
+}
+
+void WhisperTranscriber::applyDecodeParams()
+{
+    const std::string language = decodeLanguage();
+    whisper_bridge_decode_params params = buildDecodeParams(language);
+
+    // The bridge copies the strings; the model and decoding state are untouched
+    if (finalThread_.joinable())
+    {
+        finalParamsDirty_.store(true); // The final thread is using whisperContext_; it reloads before its next decode
+    }
+    else
+    {
+        whisper_bridge_set_decode_params(whisperContext_, &params);
+    }
+
+    if (fallbackContext_)
+    {
+        whisper_bridge_set_decode_params(fallbackContext_, &params);
+    }
+
+    if (partialContext_)
+    {
+        params.threads = config_.threads;
+        whisper_bridge_set_decode_params(partialContext_, &params);
+    }
+}
+
+void WhisperTranscriber::feedLanguageProbe(const float *samples, size_t count)
+{
+    if (!config_.lockLanguage || config_.language != "auto" || languageDetectionFailed_)
+    {
+        return;
+    }
+
+    const size_t detectSamples = static_cast<size_t>(std::max(1, config_.languageDetectSeconds)) * 16000;
+    if (!languageProbing_)
+    {
+        const bool pinned = !getSessionLanguage().empty();
+        samplesSincePin_ += pinned ? count : 0;
+        const size_t recheckSamples = static_cast<size_t>(std::max(0, config_.languageRecheckSeconds)) * 16000;
+        if (pinned && (recheckSamples == 0 || samplesSincePin_ < recheckSamples))
+        {
+            return;
+        }
+
+        // First detection of the session, or a periodic re-check
+        languageProbing_ = true;
+        languageProbeTarget_ = detectSamples;
+        languageProbe_.clear();
+        languageProbe_.reserve(30 * 16000);
+    }
+
+    const size_t maxSamples = 30 * 16000;
+    const size_t take = std::min(count, maxSamples - languageProbe_.size());
+    languageProbe_.insert(languageProbe_.end(), samples, samples + take);
+
+    if (languageProbe_.size() >= languageProbeTarget_)
+    {
+        detectSessionLanguage();
+    }
+}
+
+void WhisperTranscriber::detectSessionLanguage()
+{
+    // The final thread owns the main context's state in a cascade, so detection gets its own,
+    // allocated on first use and kept for the session (re-checks and retries reuse it)
+    if (cascade_ && !languageState_)
+    {
+        languageState_ = whisper_bridge_state_init(whisperContext_);
+        if (!languageState_)
+        {
+            return;
+        }
+    }
+
+    float probability = 0.0f;
+    const char *code = whisper_bridge_detect_language(whisperContext_, cascade_ ? languageState_ : nullptr, languageProbe_.data(),
+                                                      static_cast<int>(languageProbe_.size()), config_.threads, &probability);
+
+    const size_t maxSamples = 30 * 16000;
+    if (!code)
+    {
+        std::cerr << "Language detection failed; every chunk is auto-detected" << std::endl;
+        languageDetectionFailed_ = true;
+        languageProbing_ = false;
+        languageProbe_.clear();
+        return;
+    }
+
+    if (probability < config_.languageLockConfidence && languageProbe_.size() < maxSamples)
+    {
+        // Not sure yet: try again with more audio
+        languageProbeTarget_ = std::min(maxSamples, languageProbeTarget_ + static_cast<size_t>(std::max(1, config_.languageDetectSeconds)) * 16000);
+        return;
+    }
+
+    languageProbing_ = false;
+    languageProbe_.clear();
+    samplesSincePin_ = 0;
+
+    const std::string previous = getSessionLanguage();
+    if (previous == code)
+    {
+        return;
+    }
+    if (!previous.empty() && probability < config_.languageLockConfidence)
+    {
+        return; // A re-check that is not confident keeps the current language
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(languageMutex_);
+        pinnedLanguage_ = code;
+    }
+    std::cout << "Session language: " << code << " (p=" << probability << ")" << std::endl;
+    applyDecodeParams();
+}
+
+void WhisperTranscriber::updateProfile()
+{
+    if (cascade_)
+    {
+        return; // The partial model is already low-latency and the final thread owns whisperContext_
+    }
+
+    const bool lowLatency = config_.lowLatency ||
+                            (policyActive_ && config_.overloadPolicy == OverloadPolicy::SwitchProfile) ||
+                            governorStepActive(GovernorStep::TruncateContext);
+    const whisper_bridge_profile profile = lowLatency ? WHISPER_BRIDGE_PROFILE_LOW_LATENCY : WHISPER_BRIDGE_PROFILE_DEFAULT;
+
+    if (whisper_bridge_get_profile(whisperContext_) == profile)
+    {
+        return;
+    }
+
+    whisper_bridge_set_profile(whisperContext_, profile);
+    if (fallbackContext_)
+    {
+        whisper_bridge_set_profile(fallbackContext_, profile);
+    }
+
+    if (lowLatency)
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.profileSwitches++;
+    }
+}
+
+bool WhisperTranscriber::governorStepActive(GovernorStep step) const
+{
+    const auto it = std::find(governorLadder_.begin(), governorLadder_.end(), step);
+    return it != governorLadder_.end() && (it - governorLadder_.begin()) < governorLevel_;
+}
+
+void WhisperTranscriber::applyGovernorLevel(int level)
+{
+    const bool wasGreedy = governorStepActive(GovernorStep::ReduceBeam);
+    const bool wasFallback = governorStepActive(GovernorStep::SmallerModel);
+    const int previous = governorLevel_;
+    governorLevel_ = level;
+
+    const bool greedy = governorStepActive(GovernorStep::ReduceBeam);
+    const bool fallback = governorStepActive(GovernorStep::SmallerModel);
+
+    if (greedy != wasGreedy)
+    {
+        applyDecodeParams();
+    }
+    updateProfile();
+    activeContext_ = fallback ? fallbackContext_ : whisperContext_;
+
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.beamReductions += greedy && !wasGreedy ? 1 : 0;
+        stats_.modelSwitches += fallback && !wasFallback ? 1 : 0;
+        stats_.governorLevel = level;
+    }
+
+    if (level != previous)
+    {
+        std::cerr << "Whisper RTF " << governor_->rtf() << ": decoding at degradation level " << level << "/"
+                  << governorLadder_.size() << std::endl;
+    }
+}
+
+void WhisperTranscriber::recordDecode(double audioSeconds, double decodeSeconds)
+{
+    const int level = governor_->update(audioSeconds, decodeSeconds);
+    if (level != governorLevel_)
+    {
+        applyGovernorLevel(level);
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.rtf = governor_->rtf();
+    stats_.governorStepsDown = governor_->stepsDown();
+    stats_.governorStepsUp = governor_->stepsUp();
+}
+
+void WhisperTranscriber::updateOverloadResponse()
+{
+    const bool overloaded = overloaded_.load();
+    if (overloaded == policyActive_)
+    {
+        return;
+    }
+
+    policyActive_ = overloaded;
+    if (overloaded)
+    {
+        std::cerr << "Transcription is falling behind real time; backlog above " << config_.maxQueueMs / 2 << " ms" << std::endl;
+    }
+
+    switch (config_.overloadPolicy)
+    {
+    case OverloadPolicy::Coalesce:
+        coalescing_ = overloaded && !config_.streaming;
+        break;
+    case OverloadPolicy::SwitchProfile:
+        updateProfile();
+        break;
+    case OverloadPolicy::DropOldest:
+        break;
+    }
+}
+
+void WhisperTranscriber::handleQueueGap()
+{
+    // Timestamps jump over the dropped audio, so nothing may straddle the gap
+    if (vad_)
+    {
+        vad_->flush();
+        vad_->reset(); // Re-anchors on the next chunk's timestamp
+    }
+    else if (config_.streaming)
+    {
+        whisper_bridge_flush_stream(streamContext_);
+    }
+    else if (!audioBuffer_.empty())
+    {
+        processBuffer();
+    }
+}
+
+size_t WhisperTranscriber::bufferLimit() const
+{
+    const size_t seconds = coalescing_ ? std::max<size_t>(BUFFER_SIZE_SECONDS, static_cast<size_t>(std::max(0, config_.maxSegmentLength)))
+                                       : BUFFER_SIZE_SECONDS;
+    return seconds * 16000;
+}
+
+void WhisperTranscriber::processingThreadFunction()
+{
+    std::cout << "Processing thread started" << std::endl;
 
     while (!shouldStop_.load())
     {
@@ -186,62 +1136,529 @@ void WhisperTranscriber::processingThreadFunction()
         // Process available audio data
         while (!audioQueue_.empty() && !shouldStop_.load())
         {
-            auto audioData = audioQueue_.front();
-            audioQueue_.pop();
+            AudioChunkHandle chunk;
+            audioQueue_.pop(chunk);
+            queuedSamples_ -= std::min(queuedSamples_, chunk->size());
+            if (overloaded_.load() && queuedSamples_ < static_cast<size_t>(std::max(0, config_.maxQueueMs)) * 16 / 4)
+            {
+                overloaded_.store(false);
+            }
+            const bool gap = queueGap_;
+            queueGap_ = false;
             lock.unlock();
 
-            // Add to buffer
-            audioBuffer_.insert(audioBuffer_.end(),
-                                audioData.first.begin(),
-                                audioData.first.end());
+            applyPendingLanguage();
+            updateOverloadResponse();
+            if (gap)
+            {
+                handleQueueGap();
+            }
+            consumeAudio(*chunk);
+            chunk.reset(); // Back to the pool before waiting again
+
+            lock.lock();
+        }
+    }
+
+    // Transcribe audio still queued at stop so the tail of a recording is not lost
+    AudioChunkQueue remaining;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        remaining.swap(audioQueue_);
+        queuedSamples_ = 0;
+    }
+    AudioChunkHandle chunk;
+    while (remaining.pop(chunk))
+    {
+        consumeAudio(*chunk);
+    }
+    chunk.reset();
+
+    // End an utterance cut off by the stop
+    if (vad_)
+    {
+        vad_->flush();
+    }
+    if (config_.streaming)
+    {
+        whisper_bridge_flush_stream(streamContext_);
+    }
+
+    // Process any remaining buffer
+    if (!audioBuffer_.empty())
+    {
+        processBuffer();
+    }
+
+    std::cout << "Processing thread ended" << std::endl;
+}
+
+void WhisperTranscriber::consumeAudio(const AudioChunk &chunk)
+{
+    const float *samples = chunk.data();
+    const size_t count = chunk.size();
+
+    if (vad_)
+    {
+        // Only speech re-enters the pending count, via appendToBuffer()
+        releasePendingSamples(count);
+        vad_->process(samples, count, chunk.timestamp());
+        return;
+    }
+
+    // Without the VAD, silence is part of the probe too
+    feedLanguageProbe(samples, count);
+
+    if (config_.streaming)
+    {
+        releasePendingSamples(count);
+        addStreamAudio(samples, count, chunk.timestamp());
+        return;
+    }
+
+    // Set buffer start time if this is the first chunk (file sources start at 0.0)
+    if (audioBuffer_.empty())
+    {
+        bufferStartTime_ = chunk.timestamp();
+    }
+
+    // Add to buffer
+    audioBuffer_.insert(audioBuffer_.end(), samples, samples + count);
+
+    // Check if we should process the buffer
+    const size_t minSamples = MIN_PROCESS_SIZE_SECONDS * 16000;
+    const size_t maxSamples = bufferLimit();
+
+    // Process if buffer is getting full, or if we have enough audio and the latest chunk is quiet
+    // (a coalescing buffer only decodes when full)
+    if (audioBuffer_.size() >= maxSamples ||
+        (audioBuffer_.size() >= minSamples && !coalescing_ && !detectSpeech(samples, count)))
+    {
+        processBuffer();
+    }
+}
+
+void WhisperTranscriber::appendToBuffer(const float *samples, size_t count, double timestamp)
+{
+    feedLanguageProbe(samples, count);
+
+    if (cascade_)
+    {
+        // Partials from the small model now; the utterance is kept for the final model
+        addStreamAudio(samples, count, timestamp);
+        if (audioBuffer_.empty())
+        {
+            bufferStartTime_ = timestamp;
+        }
+        audioBuffer_.insert(audioBuffer_.end(), samples, samples + count);
+        pendingSamples_.fetch_add(count);
+
+        if (audioBuffer_.size() >= static_cast<size_t>(std::max(1, config_.maxSegmentLength)) * 16000)
+        {
+            whisper_bridge_flush_stream(streamContext_);
+            submitFinal();
+        }
+        return;
+    }
+
+    if (config_.streaming)
+    {
+        // The bridge keeps its own window and reports through onStreamResult()
+        addStreamAudio(samples, count, timestamp);
+        return;
+    }
+
+    if (audioBuffer_.empty())
+    {
+        bufferStartTime_ = timestamp;
+    }
+    audioBuffer_.insert(audioBuffer_.end(), samples, samples + count);
+    pendingSamples_.fetch_add(count);
+
+    // Long monologues are cut at the buffer size rather than waiting for a pause
+    if (audioBuffer_.size() >= bufferLimit())
+    {
+        processBuffer();
+    }
+}
+
+void WhisperTranscriber::addStreamAudio(const float *samples, size_t count, double timestamp)
+{
+    const auto start = std::chrono::steady_clock::now();
+    whisper_bridge_add_audio(streamContext_, samples, static_cast<int>(count), timestamp);
+    streamDecodeSeconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    streamAudioSeconds_ += static_cast<double>(count) / 16000.0;
+
+    // Window decodes run every step, so measure over whole seconds rather than per chunk
+    if (streamAudioSeconds_ >= 1.0)
+    {
+        recordDecode(streamAudioSeconds_, streamDecodeSeconds_);
+        streamAudioSeconds_ = 0.0;
+        streamDecodeSeconds_ = 0.0;
+    }
+}
+
+void WhisperTranscriber::onStreamResult(const whisper_bridge_result *result, void *userData)
+{
+    auto *self = static_cast<WhisperTranscriber *>(userData);
+    if (!result->success)
+    {
+        std::cerr << "Streaming decode failed: " << (result->error_msg ? result->error_msg : "Unknown error") << std::endl;
+        return;
+    }
 
-            // Set buffer start time if this is the first chunk
-            if (bufferStartTime_ == 0.0)
+    // Stream timestamps are already absolute
+    for (auto &converted : self->extractResults(*result))
+    {
+        if (self->cascade_)
+        {
+            // Everything the partial model says is provisional until the final model has decoded the utterance
+            if (!converted.partial)
             {
-                bufferStartTime_ = audioData.second;
+                self->draft_ += (self->draft_.empty() ? "" : " ") + converted.text;
             }
+            converted.partial = true;
+            converted.utterance = self->utteranceId_;
+        }
+
+        if (converted.partial)
+        {
+            self->deliverResult(converted);
+        }
+        else
+        {
+            // The stream owns its audio, so these finals are not refined
+            self->emitFinal(std::move(converted), nullptr, 0, 0.0);
+        }
+    }
+}
+
+void WhisperTranscriber::submitFinal()
+{
+    if (audioBuffer_.empty())
+    {
+        return;
+    }
+
+    FinalJob job;
+    job.startTime = bufferStartTime_;
+    job.utterance = utteranceId_++;
+    job.draft.swap(draft_);
+
+    // Hand the buffer over and continue in a recycled one
+    std::vector<float> next;
+    {
+        std::lock_guard<std::mutex> lock(finalMutex_);
+        if (!spareBuffers_.empty())
+        {
+            next.swap(spareBuffers_.back());
+            spareBuffers_.pop_back();
+        }
+    }
+    if (next.capacity() == 0)
+    {
+        next.reserve(audioBuffer_.capacity());
+    }
+    job.audio.swap(audioBuffer_);
+    audioBuffer_.swap(next);
+    bufferStartTime_ = 0.0;
+
+    // When finals fall this far behind, the oldest keeps its partial-model text instead
+    FinalJob skipped;
+    bool skip = false;
+    {
+        std::lock_guard<std::mutex> lock(finalMutex_);
+        if (finalJobs_.size() >= static_cast<size_t>(std::max(1, config_.maxPendingFinals)))
+        {
+            skipped = std::move(finalJobs_.front());
+            finalJobs_.pop_front();
+            skip = true;
+        }
+        finalJobs_.push_back(std::move(job));
+    }
+    finalCondition_.notify_one();
+
+    if (!skip)
+    {
+        return;
+    }
+
+    releasePendingSamples(skipped.audio.size());
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.finalsFromPartials++;
+    }
+
+    if (!skipped.draft.empty())
+    {
+        Result result;
+        result.text = skipped.draft;
+        result.startTime = skipped.startTime;
+        result.endTime = skipped.startTime + static_cast<double>(skipped.audio.size()) / 16000.0;
+        result.confidence = 0.0f;
+        result.language = decodeLanguage();
+        result.utterance = skipped.utterance;
+        emitFinal(std::move(result), nullptr, 0, 0.0);
+    }
+
+    skipped.audio.clear();
+    std::lock_guard<std::mutex> lock(finalMutex_);
+    spareBuffers_.push_back(std::move(skipped.audio));
+}
+
+void WhisperTranscriber::finalThreadFunction()
+{
+    lowerThreadPriority();
+
+    while (true)
+    {
+        FinalJob job;
+        {
+            std::unique_lock<std::mutex> lock(finalMutex_);
+            finalCondition_.wait(lock, [this]()
+                                 { return finalStop_ || !finalJobs_.empty(); });
+            if (finalJobs_.empty())
+            {
+                break; // Stopped and drained
+            }
+            job = std::move(finalJobs_.front());
+            finalJobs_.pop_front();
+        }
+
+        if (finalParamsDirty_.exchange(false))
+        {
+            const std::string language = decodeLanguage();
+            const whisper_bridge_decode_params params = buildDecodeParams(language);
+            whisper_bridge_set_decode_params(whisperContext_, &params);
+        }
+
+        auto results = transcribeWithContext(whisperContext_, job.audio.data(), job.audio.size());
+        releasePendingSamples(job.audio.size());
+
+        for (auto &result : results)
+        {
+            offsetTimes(result, job.startTime);
+            result.partial = false;
+            result.utterance = job.utterance;
+            emitFinal(std::move(result), job.audio.data(), job.audio.size(), job.startTime);
+        }
+
+        job.audio.clear();
+        std::lock_guard<std::mutex> lock(finalMutex_);
+        spareBuffers_.push_back(std::move(job.audio));
+    }
+}
+
+void WhisperTranscriber::deliverResult(const Result &result)
+{
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    if (firstResultMs_.load() < 0.0)
+    {
+        firstResultMs_.store(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sessionStart_).count());
+    }
+    if (resultCallback_)
+    {
+        resultCallback_(result);
+    }
+}
+
+void WhisperTranscriber::emitFinal(Result result, const float *audio, size_t count, double audioStart)
+{
+    {
+        std::lock_guard<std::mutex> lock(transcriptMutex_);
+        result.segmentId = transcript_.size();
+        transcript_.push_back(result);
+        transcript_.back().tokens.clear(); // Text and timing are enough for the transcript
+        refineStats_.finalSegments++;
+    }
+    deliverResult(result);
+
+    if (!refineThread_.joinable() || !audio || count == 0 ||
+        !isLowConfidence(result, config_.refineConfidenceThreshold, config_.refineLogprobThreshold))
+    {
+        return;
+    }
+
+    // The segment with a little audio either side; segment boundaries are approximate
+    const double margin = 0.2;
+    const double firstSecond = std::max(0.0, result.startTime - audioStart - margin);
+    const double lastSecond = std::max(0.0, result.endTime - audioStart + margin);
+    const size_t first = std::min(count, static_cast<size_t>(firstSecond * 16000.0));
+    const size_t last = std::min(count, static_cast<size_t>(lastSecond * 16000.0));
+    if (last <= first)
+    {
+        return;
+    }
+
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(refineMutex_);
+        if (refineJobs_.size() < static_cast<size_t>(std::max(1, config_.refineMaxPending)))
+        {
+            RefineJob job;
+            job.segmentId = result.segmentId;
+            job.audio = chunkPool_->copyOf(audio + first, last - first, audioStart + static_cast<double>(first) / 16000.0);
+            refineJobs_.push_back(std::move(job));
+            queued = true;
+        }
+    }
+    if (queued)
+    {
+        refineCondition_.notify_one();
+    }
 
-            // Check if we should process the buffer
-            const size_t minSamples = MIN_PROCESS_SIZE_SECONDS * 16000;
-            const size_t maxSamples = BUFFER_SIZE_SECONDS * 16000;
+    std::lock_guard<std::mutex> lock(transcriptMutex_);
+    refineStats_.candidates++;
+    if (!queued)
+    {
+        refineStats_.skipped++;
+    }
+}
 
-            bool shouldProcess = false;
+void WhisperTranscriber::refineThreadFunction()
+{
+    lowerThreadPriority();
 
-            // Process if buffer is getting full
-            if (audioBuffer_.size() >= maxSamples)
+    while (true)
+    {
+        RefineJob job;
+        {
+            std::unique_lock<std::mutex> lock(refineMutex_);
+            refineCondition_.wait(lock, [this]()
+                                  { return refineStop_ || !refineJobs_.empty(); });
+            if (refineJobs_.empty())
             {
-                shouldProcess = true;
+                break; // Stopped and drained
             }
-            // Or if we have enough audio and detect silence/end of speech
-            else if (audioBuffer_.size() >= minSamples)
+            job = std::move(refineJobs_.front());
+            refineJobs_.pop_front();
+        }
+
+        const std::string language = decodeLanguage();
+        whisper_bridge_decode_params params = refineParams_;
+        params.language = language.c_str();
+
+        whisper_bridge_result bridgeResult = whisper_bridge_transcribe_with_state_params(
+            whisperContext_, refineState_, job.audio->data(), static_cast<int>(job.audio->size()), &params);
+        if (!bridgeResult.success)
+        {
+            std::cerr << "Refinement decode failed: " << (bridgeResult.error_msg ? bridgeResult.error_msg : "Unknown error") << std::endl;
+            whisper_bridge_free_result(&bridgeResult);
+            continue;
+        }
+        auto results = extractResults(bridgeResult);
+        whisper_bridge_free_result(&bridgeResult);
+
+        // Join the segments of the second pass; confidence is the mean over all its tokens
+        std::string text;
+        std::vector<Token> tokens;
+        float confidenceSum = 0.0f;
+        for (auto &result : results)
+        {
+            offsetTimes(result, job.audio->timestamp());
+            text += (text.empty() ? "" : " ") + result.text;
+            confidenceSum += result.confidence;
+            tokens.insert(tokens.end(), result.tokens.begin(), result.tokens.end());
+        }
+        float confidence = results.empty() ? 0.0f : confidenceSum / results.size();
+        if (!tokens.empty())
+        {
+            float sum = 0.0f;
+            for (const auto &token : tokens)
             {
-                // Simple speech detection - check if recent audio is quiet
-                if (detectSpeech(audioData.first))
-                {
-                    // Continue accumulating if speech is ongoing
-                }
-                else
-                {
-                    shouldProcess = true;
-                }
+                sum += token.probability;
             }
+            confidence = sum / tokens.size();
+        }
+
+        Correction correction;
+        {
+            std::lock_guard<std::mutex> lock(transcriptMutex_);
+            refineStats_.redecoded++;
+            refineStats_.redecodedSeconds += static_cast<double>(job.audio->size()) / 16000.0;
 
-            if (shouldProcess)
+            Result &entry = transcript_[job.segmentId];
+            if (text.empty() || text == entry.text || confidence <= entry.confidence)
             {
-                processBuffer();
+                continue; // Keep the first pass
             }
 
-            lock.lock();
+            correction.segmentId = job.segmentId;
+            correction.previousText = entry.text;
+            entry.text = text;
+            entry.confidence = confidence;
+            refineStats_.corrected++;
+            correction.result = entry;
+        }
+        correction.result.tokens = std::move(tokens);
+
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        if (correctionCallback_)
+        {
+            correctionCallback_(correction);
         }
     }
+}
 
-    // Process any remaining buffer
-    if (!audioBuffer_.empty())
+void WhisperTranscriber::setCorrectionCallback(std::function<void(const Correction &)> callback)
+{
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    correctionCallback_ = callback;
+}
+
+std::vector<WhisperTranscriber::Result> WhisperTranscriber::getTranscript() const
+{
+    std::lock_guard<std::mutex> lock(transcriptMutex_);
+    return transcript_;
+}
+
+std::string WhisperTranscriber::getTranscriptText() const
+{
+    std::lock_guard<std::mutex> lock(transcriptMutex_);
+    std::string text;
+    for (const auto &result : transcript_)
     {
-        processBuffer();
+        text += (text.empty() ? "" : " ") + result.text;
     }
+    return text;
+}
 
-    std::cout << "Processing thread ended" << std::endl;
+WhisperTranscriber::RefinementStats WhisperTranscriber::getRefinementStats() const
+{
+    std::lock_guard<std::mutex> lock(transcriptMutex_);
+    return refineStats_;
+}
+
+WhisperTranscriber::StartupTimeline WhisperTranscriber::getStartupTimeline() const
+{
+    StartupTimeline timeline;
+    timeline.loadMs = loadMs_;
+    timeline.warmupMs = warmupMs_;
+    timeline.firstResultMs = firstResultMs_.load();
+    return timeline;
+}
+
+void WhisperTranscriber::offsetTimes(Result &result, double offset)
+{
+    result.startTime += offset;
+    result.endTime += offset;
+    for (auto &token : result.tokens)
+    {
+        token.startTime += offset;
+        token.endTime += offset;
+    }
+}
+
+void WhisperTranscriber::onSegment(const whisper_bridge_result *segment, void *userData)
+{
+    auto *self = static_cast<WhisperTranscriber *>(userData);
+    for (auto &result : self->extractResults(*segment))
+    {
+        // Segment times are relative to the buffer being transcribed
+        offsetTimes(result, self->segmentOffset_);
+        self->segmentsReported_++;
+        self->emitFinal(std::move(result), self->audioBuffer_.data(), self->audioBuffer_.size(), self->segmentOffset_);
+    }
 }
 
 bool WhisperTranscriber::processBuffer()
@@ -251,16 +1668,38 @@ bool WhisperTranscriber::processBuffer()
         return false;
     }
 
-    // Create a copy of the buffer for processing
-    std::vector<float> audioToProcess = audioBuffer_;
+    // Whisper reads the buffer in place; nothing is appended until it returns
+    const size_t sampleCount = audioBuffer_.size();
     double startTime = bufferStartTime_;
 
-    // Clear the buffer for new audio
-    audioBuffer_.clear();
-    bufferStartTime_ = 0.0;
+    // Transcribe the audio; with segment callbacks, results arrive through onSegment() while Whisper decodes
+    whisper_bridge_context *context = activeContext_;
+    if (config_.segmentCallbacks)
+    {
+        segmentOffset_ = startTime;
+        segmentsReported_ = 0;
+        whisper_bridge_set_segment_callback(context, &WhisperTranscriber::onSegment, this);
+    }
 
-    // Transcribe the audio
-    auto results = transcribe(audioToProcess);
+    const auto decodeStart = std::chrono::steady_clock::now();
+    auto results = transcribeWithContext(context, audioBuffer_.data(), sampleCount);
+    const double decodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - decodeStart).count();
+    releasePendingSamples(sampleCount);
+
+    if (coalescing_)
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.coalescedDecodes++;
+    }
+
+    if (config_.segmentCallbacks)
+    {
+        whisper_bridge_set_segment_callback(context, nullptr, nullptr);
+        if (segmentsReported_ > 0)
+        {
+            results.clear(); // Already delivered segment by segment
+        }
+    }
 
     // Send results to callback
     for (const auto &result : results)
@@ -269,30 +1708,36 @@ bool WhisperTranscriber::processBuffer()
         {
             // Adjust timestamps relative to the buffer start
             Result adjustedResult = result;
-            adjustedResult.startTime += startTime;
-            adjustedResult.endTime += startTime;
+            offsetTimes(adjustedResult, startTime);
 
-            resultCallback_(adjustedResult);
+            emitFinal(std::move(adjustedResult), audioBuffer_.data(), sampleCount, startTime);
         }
     }
 
+    // Clear the buffer for new audio (capacity is kept)
+    audioBuffer_.clear();
+    bufferStartTime_ = 0.0;
+
+    // May switch the profile or model for the next buffer
+    recordDecode(static_cast<double>(sampleCount) / 16000.0, decodeSeconds);
+
     return true;
 }
 
-bool WhisperTranscriber::detectSpeech(const std::vector<float> &audioData) const
+bool WhisperTranscriber::detectSpeech(const float *samples, size_t count) const
 {
-    if (audioData.empty())
+    if (!samples || count == 0)
     {
         return false;
     }
 
     // Simple energy-based speech detection
     float energy = 0.0f;
-    for (float sample : audioData)
+    for (size_t i = 0; i < count; i++)
     {
-        energy += sample * sample;
+        energy += samples[i] * samples[i];
     }
-    energy /= audioData.size();
+    energy /= count;
 
     // Return true if energy is above threshold (indicates speech)
     return energy > (config_.silenceThreshold * config_.silenceThreshold);
@@ -301,30 +1746,66 @@ bool WhisperTranscriber::detectSpeech(const std::vector<float> &audioData) const
 std::vector<WhisperTranscriber::Result> WhisperTranscriber::extractResults(const whisper_bridge_result &bridge_result) const
 {
     std::vector<Result> results;
+    const std::string language = bridge_result.language ? bridge_result.language : decodeLanguage();
 
-    if (bridge_result.text && strlen(bridge_result.text) > 0)
+    auto addResult = [&](const char *text, int64_t startMs, int64_t endMs, float confidence) -> Result *
     {
-        Result result;
-        result.text = bridge_result.text;
-        result.startTime = bridge_result.start_time_ms / 1000.0; // Convert from milliseconds to seconds
-        result.endTime = bridge_result.end_time_ms / 1000.0;
-        result.confidence = bridge_result.confidence;
-        result.language = config_.language;
+        if (!text)
+        {
+            return nullptr;
+        }
 
         // Trim whitespace
-        result.text.erase(result.text.begin(),
-                          std::find_if(result.text.begin(), result.text.end(),
-                                       [](unsigned char ch)
-                                       { return !std::isspace(ch); }));
-        result.text.erase(std::find_if(result.text.rbegin(), result.text.rend(),
-                                       [](unsigned char ch)
-                                       { return !std::isspace(ch); })
-                              .base(),
-                          result.text.end());
-
-        if (!result.text.empty())
-        {
-            results.push_back(result);
+        const char *begin = text;
+        const char *end = text + strlen(text);
+        while (begin < end && std::isspace(static_cast<unsigned char>(*begin)))
+        {
+            begin++;
+        }
+        while (end > begin && std::isspace(static_cast<unsigned char>(end[-1])))
+        {
+            end--;
+        }
+        if (begin == end)
+        {
+            return nullptr;
+        }
+
+        Result result;
+        result.text.assign(begin, end);
+        result.startTime = startMs / 1000.0; // Convert from milliseconds to seconds
+        result.endTime = endMs / 1000.0;
+        result.confidence = confidence;
+        result.language = language;
+        result.partial = bridge_result.is_partial;
+        results.push_back(std::move(result));
+        return &results.back();
+    };
+
+    if (bridge_result.n_segments == 0)
+    {
+        // Streaming windows carry one span without token detail
+        addResult(bridge_result.text, bridge_result.start_time_ms, bridge_result.end_time_ms, bridge_result.confidence);
+        return results;
+    }
+
+    // One result per decoded segment, with its tokens
+    results.reserve(bridge_result.n_segments);
+    for (int i = 0; i < bridge_result.n_segments; i++)
+    {
+        const whisper_bridge_segment &segment = bridge_result.segments[i];
+        Result *result = addResult(segment.text, segment.start_time_ms, segment.end_time_ms, segment.confidence);
+        if (!result)
+        {
+            continue;
+        }
+
+        result->tokens.reserve(segment.n_tokens);
+        for (int j = segment.first_token; j < segment.first_token + segment.n_tokens; j++)
+        {
+            const whisper_bridge_token &token = bridge_result.tokens[j];
+            result->tokens.push_back({token.id, token.text ? token.text : "", token.p, token.plog,
+                                      token.t0_ms / 1000.0, token.t1_ms / 1000.0});
         }
     }
 
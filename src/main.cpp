@@ -11,6 +11,7 @@
  * Example:
  *   ./audio-transcriber ggml-base.en.bin
  *   ./audio-transcriber ggml-base.en.bin --device 1 --language en
+ *   ./audio-transcriber ggml-base.en.bin --input meeting.wav --max-speed
  */
 
 #include <iostream>
@@ -22,8 +23,15 @@
 #include <sstream>
 // include ifstream
 #include <fstream>
+#include <mutex>
+#include <cctype>
+#include <future>
+#include <memory>
+#include <tuple>
+#include <utility>
 
 #include "AudioCapture.h"
+#include "FileAudioSource.h"
 #include "WhisperTranscriber.h"
 #include "DBHelper.h"
 #include "LLMClient.h"
@@ -32,6 +40,44 @@
 
 namespace
 {
+    /**
+     * @brief A startup step running on its own thread
+     */
+    struct StartupTask
+    {
+        std::future<std::pair<bool, double>> future;
+        bool ok = false;
+        double elapsedMs = 0.0; ///< How long the step took (valid after wait())
+
+        /**
+         * @brief Block until the step has finished; rethrows its exception
+         * @return Whether the step succeeded
+         */
+        bool wait()
+        {
+            if (future.valid())
+            {
+                std::tie(ok, elapsedMs) = future.get();
+            }
+            return ok;
+        }
+    };
+
+    /**
+     * @brief Run a startup step (returning bool) concurrently with the others and time it
+     */
+    template <typename Step>
+    StartupTask startTask(Step step)
+    {
+        StartupTask task;
+        task.future = std::async(std::launch::async, [step]() mutable
+                                 {
+            const auto start = std::chrono::steady_clock::now();
+            const bool ok = step();
+            return std::make_pair(ok, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()); });
+        return task;
+    }
+
     // Global flag for graceful shutdown
     volatile std::sig_atomic_t g_shouldStop = 0;
 
@@ -64,7 +110,22 @@ namespace
         std::cout << "Options:" << std::endl;
         std::cout << "  --device <id>      Audio input device ID (default: 0)" << std::endl;
         std::cout << "  --language <code>  Language code (en, es, fr, etc. or 'auto')" << std::endl;
+        std::cout << "  --language-recheck <s>  With 'auto': re-detect the pinned session language every s seconds of audio" << std::endl;
         std::cout << "  --threads <num>    Number of threads for processing (default: 4)" << std::endl;
+        std::cout << "  --input <path|->   Transcribe a WAV/raw PCM file or stdin instead of a device" << std::endl;
+        std::cout << "  --raw <rate> <ch>  Input is headerless 16-bit PCM at this rate and channel count" << std::endl;
+        std::cout << "  --max-speed        Feed input as fast as Whisper keeps up instead of in real time" << std::endl;
+        std::cout << "  --beam <n>         Beam search with n beams instead of greedy decoding" << std::endl;
+        std::cout << "  --translate        Translate speech to English" << std::endl;
+        std::cout << "  --refine           Re-decode low-confidence segments with beam search in the background and correct them" << std::endl;
+        std::cout << "  --low-latency      Encode only as much audio context as each chunk needs (faster, slightly less accurate)" << std::endl;
+        std::cout << "  --max-queue <ms>   Drop the oldest queued audio beyond this backlog (default: 30000, 0 = unbounded)" << std::endl;
+        std::cout << "  --overload <mode>  Reaction to a growing backlog: drop, coalesce or profile (default: drop)" << std::endl;
+        std::cout << "  --governor         Degrade decoding step by step while Whisper is slower than real time" << std::endl;
+        std::cout << "  --fallback-model <path>  Smaller Whisper model the governor switches to last (implies --governor)" << std::endl;
+        std::cout << "  --partial-model <path>  Live partials from this small model; each utterance is re-decoded with the main model" << std::endl;
+        std::cout << "  --stream           Show partial text every 500 ms (sliding-window decode)" << std::endl;
+        std::cout << "  --parallel [n]     Offline: split the input at silences and decode on n workers (default: all cores)" << std::endl;
         std::cout << "  --list-devices     List available audio devices" << std::endl;
         std::cout << "  --help            Show this help message" << std::endl;
         std::cout << std::endl;
@@ -72,6 +133,9 @@ namespace
         std::cout << "  " << programName << " ggml-base.en.bin" << std::endl;
         std::cout << "  " << programName << " ggml-small.en.bin --language auto" << std::endl;
         std::cout << "  " << programName << " ggml-base.en.bin --device 1 --threads 8" << std::endl;
+        std::cout << "  " << programName << " ggml-base.en.bin --input meeting.wav --max-speed" << std::endl;
+        std::cout << "  " << "ffmpeg -i talk.mp3 -f s16le -ar 16000 -ac 1 - | " << programName
+                  << " ggml-base.en.bin --input - --raw 16000 1 --max-speed" << std::endl;
         std::cout << std::endl;
         std::cout << "Download models from:" << std::endl;
         std::cout << "  https://huggingface.co/ggerganov/whisper.cpp/tree/main" << std::endl;
@@ -103,6 +167,24 @@ namespace
         unsigned int deviceId = 1;
         std::string language = "auto";
         int threads = 4;
+        std::string inputPath;
+        bool rawInput = false;
+        unsigned int rawSampleRate = 16000;
+        unsigned int rawChannels = 1;
+        bool maxSpeed = false;
+        bool parallel = false;
+        int parallelWorkers = 0;
+        bool streaming = false;
+        bool lowLatency = false;
+        int beamSize = 0;
+        bool translate = false;
+        bool refine = false;
+        int maxQueueMs = -1;
+        WhisperTranscriber::OverloadPolicy overloadPolicy = WhisperTranscriber::OverloadPolicy::DropOldest;
+        bool rtfGovernor = false;
+        std::string fallbackModelPath;
+        std::string partialModelPath;
+        int languageRecheckSeconds = 0;
         bool listDevices = false;
         bool showHelp = false;
         bool valid = true;
@@ -146,6 +228,91 @@ namespace
             {
                 config.threads = std::stoi(argv[++i]);
             }
+            else if (arg == "--input" && i + 1 < argc)
+            {
+                config.inputPath = argv[++i];
+            }
+            else if (arg == "--raw" && i + 2 < argc)
+            {
+                config.rawInput = true;
+                config.rawSampleRate = std::stoi(argv[++i]);
+                config.rawChannels = std::stoi(argv[++i]);
+            }
+            else if (arg == "--max-speed")
+            {
+                config.maxSpeed = true;
+            }
+            else if (arg == "--beam" && i + 1 < argc)
+            {
+                config.beamSize = std::stoi(argv[++i]);
+            }
+            else if (arg == "--translate")
+            {
+                config.translate = true;
+            }
+            else if (arg == "--max-queue" && i + 1 < argc)
+            {
+                config.maxQueueMs = std::stoi(argv[++i]);
+            }
+            else if (arg == "--overload" && i + 1 < argc)
+            {
+                const std::string mode = argv[++i];
+                if (mode == "drop")
+                {
+                    config.overloadPolicy = WhisperTranscriber::OverloadPolicy::DropOldest;
+                }
+                else if (mode == "coalesce")
+                {
+                    config.overloadPolicy = WhisperTranscriber::OverloadPolicy::Coalesce;
+                }
+                else if (mode == "profile")
+                {
+                    config.overloadPolicy = WhisperTranscriber::OverloadPolicy::SwitchProfile;
+                }
+                else
+                {
+                    config.valid = false;
+                    config.error = "Unknown overload mode: " + mode;
+                    return config;
+                }
+            }
+            else if (arg == "--governor")
+            {
+                config.rtfGovernor = true;
+            }
+            else if (arg == "--fallback-model" && i + 1 < argc)
+            {
+                config.fallbackModelPath = argv[++i];
+                config.rtfGovernor = true;
+            }
+            else if (arg == "--language-recheck" && i + 1 < argc)
+            {
+                config.languageRecheckSeconds = std::stoi(argv[++i]);
+            }
+            else if (arg == "--refine")
+            {
+                config.refine = true;
+            }
+            else if (arg == "--partial-model" && i + 1 < argc)
+            {
+                config.partialModelPath = argv[++i];
+            }
+            else if (arg == "--low-latency")
+            {
+                config.lowLatency = true;
+            }
+            else if (arg == "--stream")
+            {
+                config.streaming = true;
+            }
+            else if (arg == "--parallel")
+            {
+                config.parallel = true;
+                if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+                {
+                    config.parallelWorkers = std::stoi(argv[++i]);
+                }
+            }
             else
             {
                 config.valid = false;
@@ -154,9 +321,56 @@ namespace
             }
         }
 
+        if (config.parallel && config.inputPath.empty())
+        {
+            config.valid = false;
+            config.error = "--parallel requires --input";
+        }
+
         return config;
     }
 
+    /**
+     * @brief Read a whole file input and transcribe it on the offline worker pool
+     * @return Transcript text in timestamp order
+     */
+    std::string transcribeFileOffline(FileAudioSource &source, WhisperTranscriber &transcriber)
+    {
+        std::vector<float> audio;
+        if (source.getDurationSeconds() > 0.0)
+        {
+            audio.reserve(static_cast<size_t>(source.getDurationSeconds() * 16000.0) + 16000);
+        }
+
+        source.start([&audio](const AudioChunkHandle &chunk)
+                     { audio.insert(audio.end(), chunk->data(), chunk->data() + chunk->size()); });
+        while (!g_shouldStop && source.isCapturing())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        source.stop();
+
+        if (g_shouldStop)
+        {
+            return {};
+        }
+
+        std::mutex progressMutex;
+        auto results = transcriber.transcribeOffline(audio, [&progressMutex](size_t done, size_t total)
+                                                     {
+            std::lock_guard<std::mutex> lock(progressMutex);
+            std::cout << "\r⏳ Transcribed " << done << "/" << total << " segments" << std::flush; });
+        std::cout << std::endl;
+
+        std::string text;
+        for (const auto &result : results)
+        {
+            std::cout << "[" << std::fixed << std::setprecision(1) << result.startTime << "s] " << result.text << std::endl;
+            text += result.text + " ";
+        }
+        return text;
+    }
+
     /**
      * @brief List available audio devices
      */
@@ -227,95 +441,238 @@ int fullFlow(int argc, char *argv[])
 
     try
     {
-        // Initialize the SQLite database
-        std::cout << "📦 Initializing SQLite database..." << std::endl;
-        DBHelper dbHelper("transcriptions.db");
-        std::cout << "✅ Database initialized successfully" << std::endl;
-
-        // Initialize Whisper transcriber
-        std::cout << "🤖 Loading Whisper model: " << config.modelPath << std::endl;
+        // Whisper, the LLM, the audio source and the database load in parallel; each is waited for only where it is needed
+        const auto bootStart = std::chrono::steady_clock::now();
 
         WhisperTranscriber::Config whisperConfig;
         whisperConfig.modelPath = config.modelPath;
         whisperConfig.language = config.language;
         whisperConfig.threads = config.threads;
+        whisperConfig.offlineWorkers = config.parallelWorkers;
+        whisperConfig.streaming = config.streaming;
+        whisperConfig.lowLatency = config.lowLatency;
+        whisperConfig.translate = config.translate;
+        whisperConfig.refineLowConfidence = config.refine;
+        whisperConfig.overloadPolicy = config.overloadPolicy;
+        whisperConfig.rtfGovernor = config.rtfGovernor;
+        whisperConfig.fallbackModelPath = config.fallbackModelPath;
+        whisperConfig.partialModelPath = config.partialModelPath;
+        whisperConfig.languageRecheckSeconds = config.languageRecheckSeconds;
+        if (config.maxQueueMs >= 0)
+        {
+            whisperConfig.maxQueueMs = config.maxQueueMs;
+        }
+        else if (config.maxSpeed && !config.inputPath.empty())
+        {
+            // Max-speed input already waits for Whisper through getPendingSamples; nothing should be dropped
+            whisperConfig.maxQueueMs = 0;
+        }
+        if (config.beamSize > 0)
+        {
+            whisperConfig.beamSearch = true;
+            whisperConfig.beamSize = config.beamSize;
+        }
 
         WhisperTranscriber transcriber(whisperConfig);
 
-        if (!transcriber.initialize())
-        {
-            std::cerr << "❌ Failed to initialize Whisper transcriber" << std::endl;
-            std::cerr << "   Please check that the model file exists and is valid" << std::endl;
-            return 1;
-        }
+        LLMClient::Config llmConfig;
+        llmConfig.modelPath = "models/qwen2.5-0.5b-instruct-q4_k_m.gguf";
+        llmConfig.threads = 4; // Adjust based on your M1's capabilities
+        llmConfig.contextSize = 16384; // Long transcripts are summarized in chunks, so the prompt no longer has to fit whole
+        llmConfig.maxTokens = 4096;
+        llmConfig.temperature = 0.7f;
 
-        std::cout << "✅ Whisper model loaded successfully" << std::endl;
+        LLMClient llmClient(llmConfig);
+
+        std::unique_ptr<DBHelper> dbHelper;
+        std::unique_ptr<AudioSource> source;
+        FileAudioSource *fileSource = nullptr;
+
+        // Startup tasks; declared after everything they touch so an early return waits for them first
+        StartupTask database = startTask([&dbHelper]()
+                                         {
+            std::cout << "📦 Initializing SQLite database..." << std::endl;
+            dbHelper = std::make_unique<DBHelper>("transcriptions.db");
+            std::cout << "✅ Database initialized successfully" << std::endl;
+            return true; });
+
+        StartupTask whisper = startTask([&transcriber, &config]()
+                                        {
+            std::cout << "🤖 Loading Whisper model: " << config.modelPath << std::endl;
+            return transcriber.initialize(); });
+
+        // The summary is wanted the moment capture ends, so the LLM is resident long before that
+        StartupTask llm = startTask([&llmClient]()
+                                    { return llmClient.initialize(); });
+
+        // Initialize the audio source: a live device, or a file/stdin for batch work
+        StartupTask audio = startTask([&]()
+                                      {
+            if (!config.inputPath.empty())
+            {
+                std::cout << "📂 Opening audio input: " << config.inputPath << std::endl;
+
+                FileAudioSource::Config fileConfig;
+                fileConfig.path = config.inputPath;
+                fileConfig.format = config.rawInput ? FileAudioSource::InputFormat::Raw : FileAudioSource::InputFormat::Auto;
+                fileConfig.rawSampleRate = config.rawSampleRate;
+                fileConfig.rawChannels = config.rawChannels;
+                fileConfig.maxSpeed = config.maxSpeed || config.parallel;
+
+                auto file = std::make_unique<FileAudioSource>(fileConfig);
+                if (!file->initialize())
+                {
+                    std::cerr << "❌ Failed to open audio input: " << config.inputPath << std::endl;
+                    return false;
+                }
+
+                // Max-speed mode backs off while Whisper has a backlog (the offline pool reads everything up front)
+                if (!config.parallel)
+                {
+                    file->setPendingSamplesProvider([&transcriber]()
+                                                    { return transcriber.getPendingSamples(); });
+                }
+                std::cout << "✅ Audio input opened" << std::endl;
+                fileSource = file.get();
+                source = std::move(file);
+                return true;
+            }
 
-        // Initialize audio capture
-        std::cout << "🎙️  Initializing audio capture..." << std::endl;
+            std::cout << "🎙️  Initializing audio capture..." << std::endl;
 
-        AudioCapture::Config audioConfig;
-        audioConfig.deviceId = config.deviceId;
+            AudioCapture::Config audioConfig;
+            audioConfig.deviceId = config.deviceId;
 
-        AudioCapture capture(audioConfig);
+            auto capture = std::make_unique<AudioCapture>(audioConfig);
 
-        capture.printAvailableDevices(); // Ensure devices are populated
+            capture->printAvailableDevices(); // Ensure devices are populated
 
-        if (!capture.initialize())
+            if (!capture->initialize())
+            {
+                std::cerr << "❌ Failed to initialize audio capture" << std::endl;
+                std::cerr << "   Please check that your microphone is connected and accessible" << std::endl;
+                return false;
+            }
+
+            // List the device we're using
+            auto devices = capture->getAvailableDevices();
+            if (config.deviceId < devices.size())
+            {
+                std::cout << "🎧 Using audio device: " << devices[config.deviceId] << std::endl;
+            }
+            std::cout << "✅ Audio capture initialized" << std::endl;
+            source = std::move(capture);
+            return true; });
+
+        // Gate: transcription needs Whisper and the audio source
+        if (!whisper.wait())
         {
-            std::cerr << "❌ Failed to initialize audio capture" << std::endl;
-            std::cerr << "   Please check that your microphone is connected and accessible" << std::endl;
+            std::cerr << "❌ Failed to initialize Whisper transcriber" << std::endl;
+            std::cerr << "   Please check that the model file exists and is valid" << std::endl;
             return 1;
         }
+        std::cout << "✅ Whisper model loaded successfully" << std::endl;
 
-        // List the device we're using
-        auto devices = capture.getAvailableDevices();
-        if (config.deviceId < devices.size())
+        if (!audio.wait())
         {
-            std::cout << "🎧 Using audio device: " << devices[config.deviceId] << std::endl;
+            return 1;
         }
-        std::cout << "✅ Audio capture initialized" << std::endl;
+
+        // Nothing is captured that could not be saved
+        database.wait();
+
+        std::cout << "⏱️  Ready to transcribe after "
+                  << static_cast<int>(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - bootStart).count())
+                  << " ms (database " << static_cast<int>(database.elapsedMs) << " ms, Whisper " << static_cast<int>(whisper.elapsedMs)
+                  << " ms, audio " << static_cast<int>(audio.elapsedMs) << " ms)" << std::endl;
         std::cout << std::endl;
 
         static std::string consolidatedText;
 
-        // Set up real-time transcription callback
-        transcriber.startRealTimeProcessing([](const WhisperTranscriber::Result &result)
-                                            {
-            if (!result.text.empty()) {
-                consolidatedText += result.text + " ";
-                // clear the console line
+        if (config.parallel && fileSource)
+        {
+            std::cout << "🎧 Transcribing " << config.inputPath << " offline... (Press Ctrl+C to stop)" << std::endl;
+            consolidatedText = transcribeFileOffline(*fileSource, transcriber);
+        }
+        else
+        {
+            // Corrected segments rewrite the committed text (called under the same lock as the result callback)
+            transcriber.setCorrectionCallback([&transcriber](const WhisperTranscriber::Correction &)
+                                              {
+                consolidatedText = transcriber.getTranscriptText() + " ";
                 system("clear");
-                std::cout << consolidatedText << std::endl;
-                // Optionally, you can print the result immediately
-                // std::cout << "[" << getCurrentTimestamp() << "] " << result.text << std::endl;
-            } });
+                std::cout << consolidatedText << std::endl; });
+
+            // Set up real-time transcription callback
+            transcriber.startRealTimeProcessing([](const WhisperTranscriber::Result &result)
+                                                {
+                if (!result.text.empty()) {
+                    // Partial results are shown after the committed text until a final result replaces them
+                    if (!result.partial) {
+                        consolidatedText += result.text + " ";
+                    }
+                    // clear the console line
+                    system("clear");
+                    std::cout << consolidatedText << (result.partial ? result.text : "") << std::endl;
+                    // Optionally, you can print the result immediately
+                    // std::cout << "[" << getCurrentTimestamp() << "] " << result.text << std::endl;
+                } });
+
+            // Start audio capture with callback
+            bool captureStarted = source->start([&transcriber](const AudioChunkHandle &chunk)
+                                                { transcriber.addAudioData(chunk); });
+
+            if (!captureStarted)
+            {
+                std::cerr << "❌ Failed to start audio capture" << std::endl;
+                return 1;
+            }
 
-        // Start audio capture with callback
-        bool captureStarted = capture.start([&transcriber](const std::vector<float> &audioData, double timestamp)
-                                            { transcriber.addAudioData(audioData, timestamp); });
+            if (fileSource)
+            {
+                std::cout << "🎧 Transcribing " << config.inputPath << "... (Press Ctrl+C to stop)" << std::endl;
+            }
+            else
+            {
+                std::cout << "🎤 Listening... (Press Ctrl+C to stop)" << std::endl;
+            }
+            std::cout << "═══════════════════════════════════" << std::endl;
 
-        if (!captureStarted)
-        {
-            std::cerr << "❌ Failed to start audio capture" << std::endl;
-            return 1;
-        }
+            // Main loop - wait for shutdown signal or the end of a file input
+            while (!g_shouldStop && source->isCapturing())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
 
-        std::cout << "🎤 Listening... (Press Ctrl+C to stop)" << std::endl;
-        std::cout << "═══════════════════════════════════" << std::endl;
+            // Cleanup
+            std::cout << std::endl
+                      << "🛑 Stopping..." << std::endl;
 
-        // Main loop - wait for shutdown signal
-        while (!g_shouldStop)
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
+            source->stop();
+            transcriber.stopRealTimeProcessing(); // Transcribes whatever is still queued
 
-        // Cleanup
-        std::cout << std::endl
-                  << "🛑 Stopping..." << std::endl;
+            const auto overload = transcriber.getOverloadStats();
+            std::cout << "⏱️  Whisper RTF " << overload.rtf << ", peak backlog " << overload.peakQueuedSamples / 16 << " ms" << std::endl;
+            if (overload.overloadEvents > 0 || overload.governorStepsDown > 0)
+            {
+                std::cout << "⚠️  Overload: " << overload.overloadEvents << " events, "
+                          << overload.droppedSamples / 16 << " ms dropped in " << overload.droppedChunks << " chunks, "
+                          << overload.coalescedDecodes << " coalesced decodes, " << overload.profileSwitches << " profile switches, "
+                          << overload.beamReductions << " beam reductions, " << overload.modelSwitches << " model switches" << std::endl;
+            }
+
+            if (config.refine)
+            {
+                const auto refinement = transcriber.getRefinementStats();
+                std::cout << "🔁 Refined " << refinement.redecoded << " of " << refinement.finalSegments << " segments ("
+                          << refinement.skipped << " skipped), " << refinement.corrected << " corrected" << std::endl;
+            }
 
-        capture.stop();
-        transcriber.stopRealTimeProcessing();
+            const auto startup = transcriber.getStartupTimeline();
+            std::cout << "🚀 Whisper startup: load " << static_cast<int>(startup.loadMs) << " ms, warm-up "
+                      << static_cast<int>(startup.warmupMs) << " ms, first result " << static_cast<int>(startup.firstResultMs)
+                      << " ms after start" << std::endl;
+        }
 
         // Stop audio capture and transcription and save the final text to the DB
         std::cout << "\n📝 Saving final transcription to database..." << std::endl;
@@ -323,7 +680,7 @@ int fullFlow(int argc, char *argv[])
         // clone the consolidated text
         const std::string finalTranscription = consolidatedText;
 
-        if (!dbHelper.SaveTranscriptionResult(finalTranscription))
+        if (!dbHelper->SaveTranscriptionResult(finalTranscription))
         {
             std::cerr << "❌ Failed to save transcription to database" << std::endl;
         }
@@ -332,31 +689,53 @@ int fullFlow(int argc, char *argv[])
             std::cout << "✅ Transcription saved to database successfully" << std::endl;
         }
 
-        // Initialize LLM client
-        std::cout << "🤖 Initializing LLM for summarization..." << std::endl;
-
-        LLMClient::Config llmConfig;
-        llmConfig.modelPath = "models/qwen2.5-0.5b-instruct-q4_k_m.gguf";
-        llmConfig.threads = 4; // Adjust based on your M1's capabilities
-        llmConfig.contextSize = 32768;
-        llmConfig.maxTokens = 32768;
-        llmConfig.temperature = 0.7f;
-
-        LLMClient llmClient(llmConfig);
+        // Gate: the summary needs the LLM, which has normally been loaded since startup
+        const auto llmWaitStart = std::chrono::steady_clock::now();
+        const bool llmReady = llm.wait();
+        const double llmWaitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - llmWaitStart).count();
+        std::cout << "⏱️  Load times: database " << static_cast<int>(database.elapsedMs) << " ms, Whisper "
+                  << static_cast<int>(whisper.elapsedMs) << " ms, audio " << static_cast<int>(audio.elapsedMs) << " ms, LLM "
+                  << static_cast<int>(llm.elapsedMs) << " ms (waited " << static_cast<int>(llmWaitMs) << " ms for it)" << std::endl;
 
-        if (llmClient.initialize())
+        if (llmReady)
         {
             std::cout << "🧠 Generating summary..." << std::endl;
 
-            auto summaryResponse = llmClient.summarizeTranscript(finalTranscription);
+            // A long transcript takes a while to read in before the first word appears
+            llmClient.setPrefillProgressCallback([](int done, int total)
+                                                 {
+                std::cout << "\r   Reading transcript: " << (total > 0 ? done * 100 / total : 100) << "% ("
+                          << done << "/" << total << " tokens)" << std::flush;
+                if (done == total)
+                {
+                    std::cout << std::endl;
+                } });
+
+            // The summary appears as it is generated, under a header printed with the first piece
+            bool summaryStarted = false;
+            auto summaryResponse = llmClient.summarizeTranscript(finalTranscription, [&summaryStarted](const std::string &piece)
+                                                                 {
+                if (!summaryStarted)
+                {
+                    std::cout << "\n📝 SUMMARY:" << std::endl;
+                    std::cout << "═══════════" << std::endl;
+                    summaryStarted = true;
+                }
+                std::cout << piece << std::flush;
+                return true; });
+            llmClient.setPrefillProgressCallback(nullptr);
+            std::cout << std::endl;
 
             if (summaryResponse.success)
             {
-                std::cout << "\n📝 SUMMARY:" << std::endl;
-                std::cout << "═══════════" << std::endl;
-                std::cout << summaryResponse.text << std::endl;
                 std::cout << "\n⚡ Generated " << summaryResponse.tokensGenerated
-                          << " tokens in " << summaryResponse.inferenceTimeMs << "ms" << std::endl;
+                          << " tokens in " << summaryResponse.inferenceTimeMs << "ms (first token after "
+                          << summaryResponse.timeToFirstTokenMs << "ms)" << std::endl;
+
+                const auto startup = llmClient.getStartupTimeline();
+                std::cout << "🚀 LLM startup: load " << static_cast<int>(startup.loadMs) << " ms, warm-up "
+                          << static_cast<int>(startup.warmupMs) << " ms, first result " << static_cast<int>(startup.firstResultMs)
+                          << " ms" << std::endl;
 
                 // TODO: Save summary to database
             }
@@ -392,8 +771,8 @@ void testLLMSummary()
     LLMClient::Config llmConfig;
     llmConfig.modelPath = "models/qwen2.5-0.5b-instruct-q4_k_m.gguf";
     llmConfig.threads = 4;
-    llmConfig.contextSize = 32768;
-    llmConfig.maxTokens = 32768;
+    llmConfig.contextSize = 16384;
+    llmConfig.maxTokens = 4096;
     llmConfig.temperature = 0.7f;
 
     LLMClient llmClient(llmConfig);
@@ -424,16 +803,20 @@ void testLLMSummary()
         // std::cout << "══════════════════════" << std::endl;
 
         std::cout << "🧠 Generating summary..." << std::endl;
+        std::cout << "\n📝 SUMMARY:" << std::endl;
+        std::cout << "═══════════" << std::endl;
 
-        auto summaryResponse = llmClient.summarizeTranscript(transcriptionText);
+        auto summaryResponse = llmClient.summarizeTranscript(transcriptionText, [](const std::string &piece)
+                                                             {
+            std::cout << piece << std::flush;
+            return true; });
+        std::cout << std::endl;
 
         if (summaryResponse.success)
         {
-            std::cout << "\n📝 SUMMARY:" << std::endl;
-            std::cout << "═══════════" << std::endl;
-            std::cout << summaryResponse.text << std::endl;
             std::cout << "\n⚡ Generated " << summaryResponse.tokensGenerated
-                      << " tokens in " << summaryResponse.inferenceTimeMs << "ms" << std::endl;
+                      << " tokens in " << summaryResponse.inferenceTimeMs << "ms (first token after "
+                      << summaryResponse.timeToFirstTokenMs << "ms)" << std::endl;
         }
         else
         {